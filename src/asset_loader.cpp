@@ -0,0 +1,323 @@
+#include "asset_loader.h"
+#include "lockfree_queue.h"
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+    #include <cstdio>
+    #include <sys/stat.h>
+#else
+    #include <thread>
+#endif
+
+typedef enum AssetJobKind { ASSET_JOB_TEXTURE = 0, ASSET_JOB_ATLAS, ASSET_JOB_SOUND, ASSET_JOB_MUSIC, ASSET_JOB_PARALLAX, ASSET_JOB_FONT } AssetJobKind;
+
+struct AssetJob {
+    AssetJobKind kind;
+    AssetGroup group;
+    std::string fileName;               // Sound, music and font only
+    TextureAssetId textureId;           // Texture only
+    ParallaxSet parallaxSet;            // Parallax only
+    void *target;
+
+    // Decoded on a worker, consumed by the upload on the main thread
+    Image image;                        // Texture, atlas page and font
+    Rectangle sprites[SPRITE_COUNT];    // Atlas only
+    Wave wave;                          // Sound
+    ParallaxImages parallax;            // Parallax layers, after compositing
+    TextFont font;                      // Font glyph rectangles
+    unsigned char *data;                // Music file, streamed from memory so kept until StopAssetLoading()
+    int dataSize;
+};
+
+static std::vector<AssetJob> jobs;
+static std::string assetBasePath;
+static std::atomic<size_t> nextJob(0);          // Next job to decode
+static int jobsLoaded[ASSET_GROUP_COUNT] = { 0 };
+static int jobsQueued[ASSET_GROUP_COUNT] = { 0 };
+static int jobsLoadedTotal = 0;
+
+#if !defined(PLATFORM_WEB)
+static const unsigned int LOADER_THREADS_MAX = 4;
+
+static std::vector<std::thread> workers;
+static std::atomic<bool> stopping(false);
+static BoundedQueue<int, ASSET_JOBS_MAX> decodedJobs;   // Indices into jobs, ready for upload
+#endif
+
+#if defined(PLATFORM_WEB)
+// Files still being fetched; jobs wait until this reaches zero
+static int fetchesTotal = 0;
+static int fetchesPending = 0;
+
+static void ReportFetchStatus(void) {
+    if (fetchesPending > 0) {
+        EM_ASM({ if (Module.setStatus) Module.setStatus('Loading assets... (' + $0 + '/' + $1 + ')'); }, fetchesTotal - fetchesPending, fetchesTotal);
+    } else {
+        EM_ASM({ if (Module.setStatus) Module.setStatus(''); });
+    }
+}
+
+// Create every parent directory of path in MEMFS
+static void MakeParentDirectories(const std::string &path) {
+    for (size_t i = path.find('/', 1); i != std::string::npos; i = path.find('/', i + 1)) {
+        mkdir(path.substr(0, i).c_str(), 0755);
+    }
+}
+
+static void OnFetchLoaded(void *arg, void *data, int size) {
+    std::string *path = (std::string *)arg;
+    MakeParentDirectories(*path);
+    FILE *file = fopen(path->c_str(), "wb");
+    if (file != nullptr) {
+        fwrite(data, 1, size, file);
+        fclose(file);
+    }
+    delete path;
+    fetchesPending--;
+    ReportFetchStatus();
+}
+
+static void OnFetchError(void *arg) {
+    std::string *path = (std::string *)arg;
+    TraceLog(LOG_WARNING, "Failed to fetch %s", path->c_str());
+    delete path;
+    fetchesPending--;
+    ReportFetchStatus();
+}
+
+// Fetch every deferred file listed in the (preloaded) manifest
+static void FetchDeferredAssets(void) {
+    char *manifest = LoadFileText((assetBasePath + "asset_manifest.txt").c_str());
+    if (manifest == nullptr) return;
+
+    std::vector<std::string> files;
+    std::string text(manifest);
+    UnloadFileText(manifest);
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        if (line.compare(0, 9, "deferred ") == 0) files.push_back(line.substr(9));
+        start = end + 1;
+    }
+
+    fetchesTotal = fetchesPending = (int)files.size();
+    for (size_t i = 0; i < files.size(); i++) {
+        std::string url = files[i];
+        for (size_t p = url.find(' '); p != std::string::npos; p = url.find(' ', p)) url.replace(p, 1, "%20");
+        emscripten_async_wget_data(url.c_str(), new std::string(assetBasePath + files[i]), OnFetchLoaded, OnFetchError);
+    }
+    ReportFetchStatus();
+}
+#endif
+
+static void QueueJob(const AssetJob &job) {
+    if (jobs.size() >= ASSET_JOBS_MAX) {
+        TraceLog(LOG_WARNING, "Asset queue full, %s not loaded", job.fileName.c_str());
+        return;
+    }
+    jobs.push_back(job);
+    jobsQueued[job.group]++;
+}
+
+void QueueTextureLoad(TextureAssetId id, Texture2D *texture, AssetGroup group) {
+    AssetJob job = {};
+    job.kind = ASSET_JOB_TEXTURE;
+    job.group = group;
+    job.textureId = id;
+    job.target = texture;
+    QueueJob(job);
+}
+
+void QueueAtlasLoad(TextureAtlas *atlas, AssetGroup group) {
+    AssetJob job = {};
+    job.kind = ASSET_JOB_ATLAS;
+    job.group = group;
+    job.target = atlas;
+    QueueJob(job);
+}
+
+void QueueSoundLoad(const char *fileName, Sound *sound, AssetGroup group) {
+    AssetJob job = {};
+    job.kind = ASSET_JOB_SOUND;
+    job.group = group;
+    job.fileName = fileName;
+    job.target = sound;
+    QueueJob(job);
+}
+
+void QueueMusicLoad(const char *fileName, Music *music, AssetGroup group) {
+    AssetJob job = {};
+    job.kind = ASSET_JOB_MUSIC;
+    job.group = group;
+    job.fileName = fileName;
+    job.target = music;
+    QueueJob(job);
+}
+
+void QueueParallaxLoad(const ParallaxSet &set, ParallaxBackground *background, AssetGroup group) {
+    AssetJob job = {};
+    job.kind = ASSET_JOB_PARALLAX;
+    job.group = group;
+    job.parallaxSet = set;
+    job.target = background;
+    QueueJob(job);
+}
+
+void QueueFontLoad(const char *fileName, TextFont *font, AssetGroup group) {
+    AssetJob job = {};
+    job.kind = ASSET_JOB_FONT;
+    job.group = group;
+    job.fileName = fileName;
+    job.target = font;
+    QueueJob(job);
+}
+
+// CPU half of a job: file reads and decoding only, no GL or audio device calls
+static void DecodeAssetJob(AssetJob &job) {
+    switch (job.kind) {
+        case ASSET_JOB_TEXTURE: job.image = LoadTextureAssetImage(assetBasePath.c_str(), job.textureId); break;
+        case ASSET_JOB_ATLAS: job.image = LoadTextureAtlasImage(assetBasePath.c_str(), job.sprites); break;
+        case ASSET_JOB_SOUND: job.wave = LoadWave(job.fileName.c_str()); break;
+        case ASSET_JOB_MUSIC: job.data = LoadFileData(job.fileName.c_str(), &job.dataSize); break;
+        case ASSET_JOB_PARALLAX:
+            if (!LoadParallaxImages(assetBasePath.c_str(), job.parallaxSet, job.parallax)) {
+                TraceLog(LOG_WARNING, "Can't load parallax set %s", job.parallaxSet.folder.c_str());
+            }
+            break;
+        case ASSET_JOB_FONT: job.image = LoadTextFontImage(job.fileName.c_str(), MAGENTA, job.font); break;
+    }
+}
+
+// Main-thread half: hand the decoded data to the GPU/audio device and fill the target
+static void UploadAssetJob(AssetJob &job) {
+    switch (job.kind) {
+        case ASSET_JOB_TEXTURE:
+            *(Texture2D *)job.target = LoadTextureFromImage(job.image);
+            UnloadImage(job.image);
+            job.image = Image();
+            break;
+        case ASSET_JOB_ATLAS: {
+            TextureAtlas *atlas = (TextureAtlas *)job.target;
+            memcpy(atlas->sprites, job.sprites, sizeof(job.sprites));
+            atlas->texture = LoadTextureFromImage(job.image);
+            UnloadImage(job.image);
+            job.image = Image();
+            break;
+        }
+        case ASSET_JOB_SOUND:
+            *(Sound *)job.target = LoadSoundFromWave(job.wave);
+            UnloadWave(job.wave);
+            job.wave = Wave();
+            break;
+        case ASSET_JOB_MUSIC:
+            if (job.data != nullptr) {
+                *(Music *)job.target = LoadMusicStreamFromMemory(GetFileExtension(job.fileName.c_str()), job.data, job.dataSize);
+            }
+            break;
+        case ASSET_JOB_PARALLAX: {
+            ParallaxBackground *background = (ParallaxBackground *)job.target;
+            UploadParallax(job.parallax, *background, background->width, background->height);
+            break;
+        }
+        case ASSET_JOB_FONT:
+            if (job.image.data != nullptr) {
+                TextFont *font = (TextFont *)job.target;
+                *font = job.font;
+                UploadTextFont(job.image, *font);
+            }
+            break;
+    }
+    jobsLoaded[job.group]++;
+    jobsLoadedTotal++;
+}
+
+#if !defined(PLATFORM_WEB)
+static void LoaderWorkerLoop(void) {
+    while (!stopping.load()) {
+        size_t index = nextJob.fetch_add(1);
+        if (index >= jobs.size()) break;
+        DecodeAssetJob(jobs[index]);
+        decodedJobs.Push((int)index);   // Can't fail, the queue holds every job
+    }
+}
+#endif
+
+void StartAssetLoading(const char *basePath) {
+    assetBasePath = basePath;
+#if defined(PLATFORM_WEB)
+    FetchDeferredAssets();
+#else
+    unsigned int threads = std::thread::hardware_concurrency();
+    if (threads < 2) threads = 2;   // Still overlaps file reads with decoding on one core
+    if (threads > LOADER_THREADS_MAX) threads = LOADER_THREADS_MAX;
+    if (threads > jobs.size()) threads = (unsigned int)jobs.size();
+    for (unsigned int i = 0; i < threads; i++) workers.push_back(std::thread(LoaderWorkerLoop));
+#endif
+}
+
+bool UpdateAssetLoading(void) {
+#if defined(PLATFORM_WEB)
+    // No threads: decode and upload one job per frame, in queue order. Jobs
+    // outside the title group wait until their files have been fetched.
+    size_t index = nextJob.load();
+    if (index < jobs.size() && (jobs[index].group == ASSET_GROUP_TITLE || fetchesPending == 0)) {
+        DecodeAssetJob(jobs[index]);
+        UploadAssetJob(jobs[index]);
+        nextJob.store(index + 1);
+    }
+#else
+    // Bound the per-frame upload cost, the rest waits for the next frame
+    int index;
+    for (int i = 0; i < ASSET_UPLOADS_PER_FRAME && decodedJobs.Pop(index); i++) {
+        UploadAssetJob(jobs[index]);
+    }
+#endif
+    return IsAssetLoadingDone();
+}
+
+void StopAssetLoading(void) {
+#if !defined(PLATFORM_WEB)
+    stopping.store(true);
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    workers.clear();
+#endif
+    // Decoded but never uploaded (window closed early), plus the music file data
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (jobs[i].image.data != nullptr) UnloadImage(jobs[i].image);
+        if (jobs[i].wave.data != nullptr) UnloadWave(jobs[i].wave);
+        if (jobs[i].data != nullptr) UnloadFileData(jobs[i].data);
+        UnloadParallaxImages(jobs[i].parallax);
+    }
+    jobs.clear();
+}
+
+bool IsAssetLoadingDone(void) {
+#if defined(PLATFORM_WEB)
+    if (fetchesPending > 0) return false;
+#endif
+    return jobsLoadedTotal >= (int)jobs.size();
+}
+
+bool IsAssetGroupLoaded(AssetGroup group) {
+#if defined(PLATFORM_WEB)
+    if (group != ASSET_GROUP_TITLE && fetchesPending > 0) return false;
+#endif
+    return jobsLoaded[group] >= jobsQueued[group];
+}
+
+float GetAssetGroupProgress(AssetGroup group) {
+    float steps = (float)jobsQueued[group], done = (float)jobsLoaded[group];
+#if defined(PLATFORM_WEB)
+    if (group != ASSET_GROUP_TITLE) {
+        steps += fetchesTotal;
+        done += fetchesTotal - fetchesPending;
+    }
+#endif
+    return (steps > 0.0f) ? done / steps : 1.0f;
+}
@@ -0,0 +1,49 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "raylib.h"
+#include "assets.h"
+#include "atlas.h"
+#include "parallax.h"
+#include "text.h"
+
+//----------------------------------------------------------------------------------
+// Background asset loading
+//----------------------------------------------------------------------------------
+// Nothing is loaded before the main loop. Textures, fonts, sounds and music are queued
+// here, then decoded (PNG/MP3/OGG decode, resize, atlas packing, parallax compositing) by a small pool
+// of worker threads. Finished Image/Wave data goes on a queue that the main thread
+// drains a few jobs per frame from UpdateAssetLoading(), doing only the GL/audio
+// upload there, so the window draws from the first frame.
+//
+// Jobs belong to a group so screens can wait for just what they draw: the LOGO
+// screen waits for ASSET_GROUP_TITLE, mode select for ASSET_GROUP_GAMEPLAY.
+//
+// On PLATFORM_WEB there are no threads: jobs decode and upload on the main thread,
+// one per frame. The files listed as "deferred" in asset_manifest.txt are not in
+// the preload bundle; they are fetched asynchronously into MEMFS first, with
+// progress reported through Module.setStatus, and ASSET_GROUP_GAMEPLAY jobs wait
+// for them.
+
+typedef enum AssetGroup { ASSET_GROUP_TITLE = 0, ASSET_GROUP_GAMEPLAY, ASSET_GROUP_COUNT } AssetGroup;
+
+#define ASSET_JOBS_MAX 64               // Queued jobs, total
+#define ASSET_UPLOADS_PER_FRAME 2       // Finished jobs uploaded by each UpdateAssetLoading() call
+
+// Targets are written by UpdateAssetLoading() on the main thread and stay zeroed until then
+void QueueTextureLoad(TextureAssetId id, Texture2D *texture, AssetGroup group);
+void QueueAtlasLoad(TextureAtlas *atlas, AssetGroup group);
+void QueueSoundLoad(const char *fileName, Sound *sound, AssetGroup group);
+void QueueMusicLoad(const char *fileName, Music *music, AssetGroup group);
+void QueueParallaxLoad(const ParallaxSet &set, ParallaxBackground *background, AssetGroup group);  // Set background width/height first
+void QueueFontLoad(const char *fileName, TextFont *font, AssetGroup group);   // Sprite font, MAGENTA between glyphs
+
+void StartAssetLoading(const char *basePath);   // Call once after queueing
+bool UpdateAssetLoading(void);                  // Call once per frame, true once everything is loaded
+void StopAssetLoading(void);                    // Join workers, free undelivered and retained data (after unloading music)
+
+bool IsAssetLoadingDone(void);
+bool IsAssetGroupLoaded(AssetGroup group);
+float GetAssetGroupProgress(AssetGroup group);  // 0.0 .. 1.0
+
+#endif // ASSET_LOADER_H
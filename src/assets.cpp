@@ -0,0 +1,119 @@
+#include "assets.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static const char COOKED_MAGIC[4] = { 'M', 'G', 'C', 'K' };
+static const uint32_t COOKED_VERSION = 2;   // 2: parallax layers keep their source size
+
+struct CookedHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t mipmaps;
+    uint32_t dataSize;
+};
+
+#define COOKED_SIZE_MAX 16384         // Largest width or height a cooked image may claim
+
+// Whether a header describes pixel data LoadTextureFromImage() can take as is
+static bool IsCookedHeaderValid(const CookedHeader &header) {
+    if (memcmp(header.magic, COOKED_MAGIC, sizeof(header.magic)) != 0 || header.version != COOKED_VERSION) return false;
+    if (header.width == 0 || header.width > COOKED_SIZE_MAX || header.height == 0 || header.height > COOKED_SIZE_MAX) return false;
+    if (header.format < PIXELFORMAT_UNCOMPRESSED_GRAYSCALE || header.format > PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA) return false;
+    if (header.mipmaps != 1) return false;  // Only the base level is stored
+    return (int)header.dataSize == GetPixelDataSize((int)header.width, (int)header.height, (int)header.format);
+}
+
+const TextureAsset TEXTURE_ASSETS[TEXTURE_ASSET_COUNT] = {
+    { "resources/textures/parallax/background 2/Plan-5.png", "parallax_0", 0, 0 },
+    { "resources/textures/parallax/background 2/Plan-4.png", "parallax_1", 0, 0 },
+    { "resources/textures/parallax/background 2/Plan-3.png", "parallax_2", 0, 0 },
+    { "resources/textures/parallax/background 2/Plan-2.png", "parallax_3", 0, 0 },
+    { "resources/textures/parallax/background 2/Plan-1.png", "parallax_4", 0, 0 },
+};
+
+bool SaveCookedImage(const char *fileName, Image image) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == nullptr) return false;
+
+    CookedHeader header;
+    memcpy(header.magic, COOKED_MAGIC, sizeof(header.magic));
+    header.version = COOKED_VERSION;
+    header.width = image.width;
+    header.height = image.height;
+    header.format = image.format;
+    header.mipmaps = image.mipmaps;
+    header.dataSize = GetPixelDataSize(image.width, image.height, image.format);
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(image.data, 1, header.dataSize, file) == header.dataSize;
+    fclose(file);
+    return ok;
+}
+
+bool IsCookedImageCurrent(const char *fileName) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == nullptr) return false;
+    CookedHeader header;
+    bool current = fread(&header, sizeof(header), 1, file) == 1 && IsCookedHeaderValid(header) &&
+                   fseek(file, 0, SEEK_END) == 0 && ftell(file) == (long)(sizeof(header) + header.dataSize);
+    fclose(file);
+    return current;
+}
+
+Image LoadCookedImage(const char *fileName) {
+    Image image = {};
+    FILE *file = fopen(fileName, "rb");
+    if (file == nullptr) return image;
+
+    // A stale or truncated file gives an empty image, and the caller loads the PNG
+    CookedHeader header;
+    if (fread(&header, sizeof(header), 1, file) == 1 && IsCookedHeaderValid(header)) {
+        // Allocated with malloc so UnloadImage() can release it
+        void *data = malloc(header.dataSize);
+        if (data != nullptr && fread(data, 1, header.dataSize, file) == header.dataSize) {
+            image.data = data;
+            image.width = header.width;
+            image.height = header.height;
+            image.format = header.format;
+            image.mipmaps = header.mipmaps;
+        } else {
+            free(data);
+        }
+    }
+    fclose(file);
+    return image;
+}
+
+Image LoadTextureAssetImage(const char *basePath, TextureAssetId id) {
+    const TextureAsset &asset = TEXTURE_ASSETS[id];
+    Image image = LoadCookedImage((std::string(basePath) + COOKED_DIR + asset.cookedName + COOKED_EXT).c_str());
+    // Cooked for another size (the table changed since): use the source instead
+    if (image.data != nullptr && asset.width > 0 && (image.width != asset.width || image.height != asset.height)) {
+        UnloadImage(image);
+        image = Image();
+    }
+    if (image.data == nullptr) {
+        image = LoadImage((std::string(basePath) + asset.sourcePath).c_str());  // Load the image file
+        if (asset.width > 0) ImageResize(&image, asset.width, asset.height); // Resize the image to the desired dimensions
+    }
+    return image;
+}
+
+Image LoadSourceImage(const char *basePath, const char *sourcePath) {
+    for (int i = 0; i < TEXTURE_ASSET_COUNT; i++) {
+        if (strcmp(TEXTURE_ASSETS[i].sourcePath, sourcePath) == 0) return LoadTextureAssetImage(basePath, (TextureAssetId)i);
+    }
+    return LoadImage((std::string(basePath) + sourcePath).c_str());
+}
+
+Texture2D LoadTextureAsset(const char *basePath, TextureAssetId id) {
+    Image image = LoadTextureAssetImage(basePath, id);
+    Texture2D texture = LoadTextureFromImage(image); // Convert Image to Texture
+    UnloadImage(image);  // Unload image from memory after conversion
+    return texture;
+}
@@ -0,0 +1,51 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Texture assets and the cooked image format
+//----------------------------------------------------------------------------------
+// `make cook` pre-resizes every texture to the size it is drawn at and stores the
+// pixels GPU-ready under resources/cooked/, so startup is a file read and an upload
+// instead of PNG decode + ImageResize. Missing or stale-format files fall back to
+// loading and resizing the source PNG.
+//
+// Cooked file layout (little endian):
+//   char magic[4] "MGCK", uint32 version, width, height, format (raylib PixelFormat),
+//   mipmaps, dataSize, then dataSize bytes of pixel data.
+
+typedef enum TextureAssetId {
+    TEXTURE_PARALLAX_0 = 0,         // Default parallax set, back to front
+    TEXTURE_PARALLAX_1,
+    TEXTURE_PARALLAX_2,
+    TEXTURE_PARALLAX_3,
+    TEXTURE_PARALLAX_4,
+    TEXTURE_ASSET_COUNT
+} TextureAssetId;
+
+struct TextureAsset {
+    const char *sourcePath;         // Relative to the resources base path
+    const char *cookedName;         // File name under COOKED_DIR, without extension
+    int width;                      // Size it's cooked/resized to, 0 to keep the source size
+    int height;
+};
+
+extern const TextureAsset TEXTURE_ASSETS[TEXTURE_ASSET_COUNT];
+
+#define COOKED_DIR "resources/cooked/"
+#define COOKED_EXT ".mgck"
+#define COOKED_ATLAS_NAME "atlas"   // The sprite atlas page, packed offline
+
+bool SaveCookedImage(const char *fileName, Image image);
+Image LoadCookedImage(const char *fileName);                    // data == NULL if missing, stale or truncated
+bool IsCookedImageCurrent(const char *fileName);                // Complete, valid and in this build's format version
+
+// Cooked image if present, otherwise the source resized at load time
+Image LoadTextureAssetImage(const char *basePath, TextureAssetId id);
+
+// Any image under the base path; goes through the cooked copy if it is a TEXTURE_ASSETS source
+Image LoadSourceImage(const char *basePath, const char *sourcePath);
+Texture2D LoadTextureAsset(const char *basePath, TextureAssetId id);
+
+#endif // ASSETS_H
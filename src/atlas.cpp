@@ -0,0 +1,107 @@
+#include "atlas.h"
+#include "assets.h"
+#include <algorithm>
+#include <string>
+
+// Gap between sprites so filtering never samples a neighbour
+static const int ATLAS_PADDING = 2;
+static const int ATLAS_MAX_SIZE = 2048;        // Safe texture size on GLES2 (Raspberry Pi)
+
+const AtlasSpriteSource ATLAS_SPRITE_SOURCES[SPRITE_COUNT] = {
+    { "resources/textures/background.png", 800, 600 },
+    { "resources/images/bonfire.png", 128, 128 },
+    { "resources/images/wooden_platform.png", 600, 32 },
+    { "resources/images/marshmallow_white.png", 64, 64 },
+    { "resources/images/marshmallow_yellow.png", 64, 64 },
+    { "resources/images/marshmallow_brown.png", 64, 64 },
+    { "resources/images/marshmallow_black.png", 64, 64 },
+};
+
+static int NextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+bool PackAtlasSprites(Rectangle sprites[SPRITE_COUNT], int *width, int *height) {
+    // Tallest first, then fill shelves left to right
+    int order[SPRITE_COUNT];
+    for (int i = 0; i < SPRITE_COUNT; i++) order[i] = i;
+    std::stable_sort(order, order + SPRITE_COUNT, [](int a, int b) {
+        return ATLAS_SPRITE_SOURCES[a].height > ATLAS_SPRITE_SOURCES[b].height;
+    });
+
+    int pageWidth = 0;
+    for (int i = 0; i < SPRITE_COUNT; i++) pageWidth = std::max(pageWidth, ATLAS_SPRITE_SOURCES[i].width + ATLAS_PADDING);
+    pageWidth = NextPowerOfTwo(pageWidth);
+
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        const AtlasSpriteSource &source = ATLAS_SPRITE_SOURCES[order[i]];
+        if (x + source.width > pageWidth) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        sprites[order[i]] = { (float)x, (float)y, (float)source.width, (float)source.height };
+        x += source.width + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, source.height + ATLAS_PADDING);
+    }
+
+    *width = pageWidth;
+    *height = NextPowerOfTwo(y + shelfHeight);
+    return *width <= ATLAS_MAX_SIZE && *height <= ATLAS_MAX_SIZE;
+}
+
+Image BuildAtlasImage(const Image images[SPRITE_COUNT], const Rectangle sprites[SPRITE_COUNT], int width, int height) {
+    Image atlas = GenImageColor(width, height, BLANK);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        Rectangle source = { 0, 0, (float)images[i].width, (float)images[i].height };
+        ImageDraw(&atlas, images[i], source, sprites[i], WHITE);
+    }
+    return atlas;
+}
+
+Image LoadTextureAtlasImage(const char *basePath, Rectangle sprites[SPRITE_COUNT]) {
+    int width = 0, height = 0;
+    if (!PackAtlasSprites(sprites, &width, &height)) {
+        TraceLog(LOG_WARNING, "Atlas sprites need %dx%d, larger than %d", width, height, ATLAS_MAX_SIZE);
+    }
+
+    // Prefer the page packed by `make cook`; its size must match the current layout
+    Image page = LoadCookedImage((std::string(basePath) + COOKED_DIR COOKED_ATLAS_NAME COOKED_EXT).c_str());
+    if (page.data != nullptr && (page.width != width || page.height != height)) {
+        TraceLog(LOG_WARNING, "Cooked atlas is %dx%d, expected %dx%d; rebuilding", page.width, page.height, width, height);
+        UnloadImage(page);
+        page = Image();
+    }
+
+    if (page.data == nullptr) {
+        Image images[SPRITE_COUNT];
+        for (int i = 0; i < SPRITE_COUNT; i++) {
+            const AtlasSpriteSource &source = ATLAS_SPRITE_SOURCES[i];
+            images[i] = LoadImage((std::string(basePath) + source.fileName).c_str());
+            ImageResize(&images[i], source.width, source.height);
+        }
+        page = BuildAtlasImage(images, sprites, width, height);
+        for (int i = 0; i < SPRITE_COUNT; i++) UnloadImage(images[i]);
+    }
+    return page;
+}
+
+TextureAtlas LoadTextureAtlas(const char *basePath) {
+    TextureAtlas atlas = {};
+    Image page = LoadTextureAtlasImage(basePath, atlas.sprites);
+    atlas.texture = LoadTextureFromImage(page);
+    UnloadImage(page);
+    return atlas;
+}
+
+void UnloadTextureAtlas(TextureAtlas &atlas) {
+    UnloadTexture(atlas.texture);
+    atlas.texture = Texture2D();
+}
+
+void DrawSprite(const TextureAtlas &atlas, AtlasSprite sprite, float x, float y) {
+    DrawTextureRec(atlas.texture, atlas.sprites[sprite], (Vector2){ x, y }, WHITE);
+}
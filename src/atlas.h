@@ -0,0 +1,53 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Gameplay sprite atlas
+//----------------------------------------------------------------------------------
+// The background, bonfire, platform and the four marshmallow states are packed
+// into one texture and drawn through source rectangles, so the whole gameplay pass
+// stays in a single rlgl batch instead of rebinding textures per sprite. The page is
+// packed offline by `make cook` when available, otherwise at load time.
+
+typedef enum AtlasSprite {
+    SPRITE_BACKGROUND = 0,
+    SPRITE_BONFIRE,
+    SPRITE_PLATFORM,
+    SPRITE_MARSHMALLOW_WHITE,       // Marshmallow states follow in order: white, yellow, brown, black
+    SPRITE_MARSHMALLOW_YELLOW,
+    SPRITE_MARSHMALLOW_BROWN,
+    SPRITE_MARSHMALLOW_BLACK,
+    SPRITE_COUNT
+} AtlasSprite;
+
+// Source image and size a sprite is resized to before packing
+struct AtlasSpriteSource {
+    const char *fileName;           // Relative to the resources base path
+    int width;
+    int height;
+};
+
+extern const AtlasSpriteSource ATLAS_SPRITE_SOURCES[SPRITE_COUNT];
+
+struct TextureAtlas {
+    Texture2D texture;
+    Rectangle sprites[SPRITE_COUNT];
+};
+
+// Shelf-pack SPRITE_COUNT sizes into a power-of-two page, returns false if they don't fit
+bool PackAtlasSprites(Rectangle sprites[SPRITE_COUNT], int *width, int *height);
+
+// Compose sprite images (already at their target size) into one atlas image
+Image BuildAtlasImage(const Image images[SPRITE_COUNT], const Rectangle sprites[SPRITE_COUNT], int width, int height);
+
+// Pack the page on the CPU only (no GL calls, safe on a loader thread), filling sprites
+Image LoadTextureAtlasImage(const char *basePath, Rectangle sprites[SPRITE_COUNT]);
+TextureAtlas LoadTextureAtlas(const char *basePath);
+void UnloadTextureAtlas(TextureAtlas &atlas);
+
+// Draw a sprite with its top-left corner at (x, y)
+void DrawSprite(const TextureAtlas &atlas, AtlasSprite sprite, float x, float y);
+
+#endif // ATLAS_H
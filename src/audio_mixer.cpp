@@ -0,0 +1,144 @@
+#include "audio_mixer.h"
+
+#if !defined(PLATFORM_WEB)
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+#endif
+
+struct Voice {
+    Sound sound;                        // Alias of the effect's Sound
+    SfxId id;
+    unsigned int started;               // playSequence when last started, 0 if never
+};
+
+static Voice voices[AUDIO_VOICES_MAX];
+static int voiceCount = 0;
+static int sfxPriority[SFX_COUNT] = { 0 };
+static unsigned int playSequence = 0;
+
+// Only touched with musicMutex held on native, where the feeder thread updates it
+static Music music;
+static bool musicPlaying = false;
+
+#if !defined(PLATFORM_WEB)
+static std::thread feeder;
+static std::mutex musicMutex;
+static std::condition_variable wakeSignal;
+static bool running = false;
+
+// Top up the music stream every AUDIO_MUSIC_FEED_MS, independent of the frame rate
+static void FeederLoop(void) {
+    std::unique_lock<std::mutex> lock(musicMutex);
+    while (running) {
+        if (musicPlaying) UpdateMusicStream(music);
+        wakeSignal.wait_for(lock, std::chrono::milliseconds(AUDIO_MUSIC_FEED_MS), []{ return !running; });
+    }
+}
+#endif
+
+void InitAudioMixer(void) {
+    SetAudioStreamBufferSizeDefault(AUDIO_MUSIC_BUFFER_FRAMES);    // Applies to streams loaded from here on
+#if !defined(PLATFORM_WEB)
+    running = true;
+    feeder = std::thread(FeederLoop);
+#endif
+}
+
+static void RemoveSfxVoices(SfxId id) {
+    int kept = 0;
+    for (int i = 0; i < voiceCount; i++) {
+        if (voices[i].id == id) UnloadSoundAlias(voices[i].sound);
+        else voices[kept++] = voices[i];
+    }
+    voiceCount = kept;
+}
+
+void CloseAudioMixer(void) {
+#if !defined(PLATFORM_WEB)
+    if (feeder.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(musicMutex);
+            running = false;
+        }
+        wakeSignal.notify_one();
+        feeder.join();
+    }
+#endif
+    StopMixerMusic();
+    for (int i = 0; i < SFX_COUNT; i++) RemoveSfxVoices((SfxId)i);
+}
+
+void SetSfxVoices(SfxId id, Sound sound, int voiceLimit, int priority) {
+    RemoveSfxVoices(id);
+    sfxPriority[id] = priority;
+    if (sound.frameCount == 0) return;      // Failed to load, stays silent
+    for (int i = 0; i < voiceLimit && voiceCount < AUDIO_VOICES_MAX; i++) {
+        Voice &voice = voices[voiceCount++];
+        voice.sound = LoadSoundAlias(sound);
+        voice.id = id;
+        voice.started = 0;
+    }
+}
+
+void PlaySfx(SfxId id) {
+    // One pass over the table: a free voice of this effect, its oldest busy one, and the total playing
+    bool playing[AUDIO_VOICES_MAX];
+    int freeVoice = -1, oldestOwn = -1, active = 0;
+    for (int i = 0; i < voiceCount; i++) {
+        playing[i] = voices[i].started != 0 && IsSoundPlaying(voices[i].sound);
+        if (playing[i]) active++;
+        if (voices[i].id != id) continue;
+        if (!playing[i]) {
+            if (freeVoice < 0) freeVoice = i;
+        } else if (oldestOwn < 0 || voices[i].started < voices[oldestOwn].started) {
+            oldestOwn = i;
+        }
+    }
+
+    int voice = freeVoice;
+    if (voice < 0) {
+        voice = oldestOwn;      // Every voice of this effect is busy, restart the oldest
+        if (voice < 0) return;  // No voices set up (not loaded yet)
+    } else if (active >= AUDIO_ACTIVE_VOICES_MAX) {
+        // Over the total: make room by stopping the lowest priority, oldest voice this one outranks or ties
+        int victim = -1;
+        for (int i = 0; i < voiceCount; i++) {
+            if (!playing[i] || sfxPriority[voices[i].id] > sfxPriority[id]) continue;
+            if (victim < 0 || sfxPriority[voices[i].id] < sfxPriority[voices[victim].id] ||
+                (sfxPriority[voices[i].id] == sfxPriority[voices[victim].id] && voices[i].started < voices[victim].started)) {
+                victim = i;
+            }
+        }
+        if (victim < 0) return;
+        StopSound(voices[victim].sound);
+    }
+
+    PlaySound(voices[voice].sound);     // Restarts it if stolen
+    voices[voice].started = ++playSequence;
+}
+
+void PlayMixerMusic(Music newMusic) {
+#if !defined(PLATFORM_WEB)
+    std::lock_guard<std::mutex> lock(musicMutex);
+#endif
+    if (musicPlaying) StopMusicStream(music);
+    music = newMusic;
+    musicPlaying = newMusic.frameCount > 0;
+    if (musicPlaying) PlayMusicStream(music);
+}
+
+void StopMixerMusic(void) {
+#if !defined(PLATFORM_WEB)
+    std::lock_guard<std::mutex> lock(musicMutex);
+#endif
+    if (musicPlaying) StopMusicStream(music);
+    musicPlaying = false;
+}
+
+void UpdateAudioMixer(void) {
+#if defined(PLATFORM_WEB)
+    if (musicPlaying) UpdateMusicStream(music);
+#endif
+}
@@ -0,0 +1,39 @@
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Audio mixer
+//----------------------------------------------------------------------------------
+// Sound effects play through a fixed table of voices, preallocated as aliases of
+// the loaded Sound (they share its sample data), so a sound can overlap itself
+// instead of restarting. Each effect gets a few voices and a priority:
+// - When all of an effect's voices are busy, its own oldest voice restarts.
+// - When it has a free voice but AUDIO_ACTIVE_VOICES_MAX are playing in total,
+//   the oldest playing voice of the lowest priority not above the new sound's is
+//   stopped to make room; if there is none the new sound is dropped.
+//
+// Music is fed by its own thread every AUDIO_MUSIC_FEED_MS, with a stream buffer
+// of AUDIO_MUSIC_BUFFER_FRAMES per half, so a stalled frame doesn't underrun it.
+// On PLATFORM_WEB (no pthreads) UpdateAudioMixer() feeds it once per frame.
+
+typedef enum SfxId { SFX_CLICK = 0, SFX_BURN, SFX_COUNT } SfxId;
+
+#define AUDIO_VOICES_MAX 16             // Voice table size, all effects together
+#define AUDIO_ACTIVE_VOICES_MAX 6       // Voices allowed to play at once
+#define AUDIO_MUSIC_BUFFER_FRAMES 8192  // Per stream sub-buffer, ~185 ms at 44.1 kHz (raylib's default is ~33 ms)
+#define AUDIO_MUSIC_FEED_MS 10
+
+void InitAudioMixer(void);              // After InitAudioDevice() and before any music is loaded
+void CloseAudioMixer(void);             // Stop feeding music and unload the voices, before unloading the sources
+
+// Give an effect voices aliasing sound (which must stay loaded), higher priority wins when stealing
+void SetSfxVoices(SfxId id, Sound sound, int voiceLimit, int priority);
+void PlaySfx(SfxId id);
+
+void PlayMixerMusic(Music music);       // Start music and hand it to the feeder, replacing any previous one
+void StopMixerMusic(void);
+void UpdateAudioMixer(void);            // Once per frame
+
+#endif // AUDIO_MIXER_H
@@ -0,0 +1,21 @@
+#ifndef GAME_MODES_H
+#define GAME_MODES_H
+
+// Game modes, also the key the leaderboard is grouped by
+typedef enum GameMode { EASY = 0, NORMAL, HARD, TIMED, SWARM } GameMode;
+
+#define GAME_MODE_COUNT 5
+
+// Convert GameMode enum to string
+inline const char* GetGameModeString(GameMode mode) {
+    switch (mode) {
+        case EASY: return "EASY";
+        case NORMAL: return "NORMAL";
+        case HARD: return "HARD";
+        case TIMED: return "TIMED";
+        case SWARM: return "SWARM";
+        default: return "UNKNOWN";
+    }
+}
+
+#endif // GAME_MODES_H
@@ -0,0 +1,247 @@
+#include "game_state.h"
+#include <cstring>
+#include <vector>
+
+const GameRules DEFAULT_GAME_RULES = {
+    { 0.8f, 1.0f, 1.5f, 1.2f, 1.0f },   // roastingSpeed: EASY, NORMAL, HARD, TIMED, SWARM
+    { 50, 100, 150, 75, 200 },          // winScore
+    30.0f,                              // timeLimit
+    { 2.0f, 4.0f, 6.0f },               // yellow/brown/burnt thresholds
+    { 0, 1, 5, -2 },                    // points per state
+    256, 4, 80.0f, 40.0f,               // swarm count, rows, spacing, scroll speed
+};
+
+// Function to reset the game
+static void ResetGame(GameState &state) {
+    state.score = 0;
+    state.timeRemaining = state.rules.timeLimit;
+    state.previousTimeRemaining = state.timeRemaining;
+    state.platformScroll = 0.0f;
+    state.previousPlatformScroll = 0.0f;
+    ResetMarshmallows(state.marshmallows);
+}
+
+// Two platforms, a marshmallow at each end
+static void LayoutClassic(GameState &state) {
+    const float x[MARSHMALLOW_COUNT] = { 150, 600, 150, 600 };
+    const float y[MARSHMALLOW_COUNT] = { 200, 200, 350, 350 };
+    SetMarshmallowLayout(state.marshmallows, x, y, MARSHMALLOW_COUNT, 0.0f);
+}
+
+// Rows on one long platform, filled column by column; the platform wraps around
+static void LayoutSwarm(GameState &state) {
+    const GameRules &rules = state.rules;
+    int count = (rules.swarmCount < MARSHMALLOW_POOL_MAX) ? rules.swarmCount : MARSHMALLOW_POOL_MAX;
+    int rows = (rules.swarmRows > 0) ? rules.swarmRows : 1;
+    std::vector<float> x(count), y(count);
+    for (int i = 0; i < count; i++) {
+        x[i] = (i / rows) * rules.swarmSpacing;
+        y[i] = SWARM_TOP + (i % rows) * SWARM_ROW_HEIGHT;
+    }
+    float worldWidth = ((count + rows - 1) / rows) * rules.swarmSpacing;
+    if (worldWidth < SWARM_MIN_WORLD_WIDTH) worldWidth = SWARM_MIN_WORLD_WIDTH;
+    SetMarshmallowLayout(state.marshmallows, x.data(), y.data(), count, worldWidth);
+}
+
+// Map the 1-5 keys to a mode, -1 if none pressed
+static int ModeKeyPressed(unsigned int keys) {
+    if (keys & GAME_KEY_ONE) return EASY;
+    if (keys & GAME_KEY_TWO) return NORMAL;
+    if (keys & GAME_KEY_THREE) return HARD;
+    if (keys & GAME_KEY_FOUR) return TIMED;
+    if (keys & GAME_KEY_FIVE) return SWARM;
+    return -1;
+}
+
+// Convert GameScreen enum to string
+const char *GetGameScreenString(GameScreen screen) {
+    switch (screen) {
+        case LOGO: return "LOGO";
+        case TITLE: return "TITLE";
+        case INSTRUCTIONS: return "INSTRUCTIONS";
+        case MODE_SELECT: return "MODE_SELECT";
+        case NAME_INPUT: return "NAME_INPUT";
+        case GAMEPLAY: return "GAMEPLAY";
+        case ENDING: return "ENDING";
+        case LEADERBOARD_SELECTION: return "LEADERBOARD_SELECTION";
+        default: return "UNKNOWN";
+    }
+}
+
+void InitGameState(GameState &state, const GameRules &rules) {
+    memset(&state, 0, sizeof(state));  // Not a GameState() temporary, that would put the pool on the stack
+    state.rules = rules;
+    state.screen = LOGO;
+    state.mode = EASY;
+    state.leaderboardMode = EASY;
+    state.roastingSpeed = rules.roastingSpeed[EASY];
+    state.winScore = rules.winScore[EASY];
+
+    LayoutClassic(state);
+    ResetGame(state);
+}
+
+void GameStep(GameState &state, const GameInput &input, float deltaTime) {
+    state.events = 0;
+    state.previousTimeRemaining = state.timeRemaining;
+
+    switch (state.screen) {
+        case LOGO:
+            if (input.keys & GAME_SIGNAL_TITLE_READY) state.screen = TITLE;  // Shown while assets load
+            break;
+
+        case TITLE:
+            if (input.keys & GAME_KEY_ENTER) {
+                state.screen = NAME_INPUT;
+            }
+            if (input.keys & GAME_KEY_L) {
+                state.screen = LEADERBOARD_SELECTION;  // Go to leaderboard mode selection screen
+            }
+            break;
+
+        case LEADERBOARD_SELECTION: {
+            int mode = ModeKeyPressed(input.keys);
+            if (mode >= 0) {
+                state.leaderboardMode = (GameMode)mode;
+                state.displayLeaderboard = true;  // Set the leaderboard to display
+                state.screen = TITLE;  // Return to title after selecting
+                state.events |= GAME_EVENT_LEADERBOARD_CHANGED;
+            }
+            break;
+        }
+
+        case MODE_SELECT: {
+            // Gameplay can't start until its sprites are in
+            int mode = (input.keys & GAME_SIGNAL_GAMEPLAY_READY) ? ModeKeyPressed(input.keys) : -1;
+            if (mode >= 0) {
+                state.mode = (GameMode)mode;
+                state.roastingSpeed = state.rules.roastingSpeed[mode];
+                state.winScore = state.rules.winScore[mode];
+                state.screen = GAMEPLAY;
+                if (mode == SWARM) LayoutSwarm(state);
+                else LayoutClassic(state);
+            }
+            ResetGame(state);  // Reset game state
+            break;
+        }
+
+        case INSTRUCTIONS:
+            if (input.keys & GAME_KEY_ENTER) {
+                state.screen = TITLE;
+            }
+            break;
+
+        case NAME_INPUT: {
+            if ((input.keys & GAME_KEY_BACKSPACE) && state.letterCount > 0) {
+                state.playerName[--state.letterCount] = '\0';
+            }
+
+            int key = input.keyPressed;
+            if (key >= 32 && key <= 125 && state.letterCount < 31) {
+                state.playerName[state.letterCount++] = (char)key;
+                state.playerName[state.letterCount] = '\0';
+            }
+
+            if ((input.keys & GAME_KEY_ENTER) && state.letterCount > 0) {
+                state.screen = MODE_SELECT;
+            }
+            break;
+        }
+
+        case GAMEPLAY: {
+            MarshmallowPool &pool = state.marshmallows;
+            UpdateMarshmallows(pool, deltaTime, state.roastingSpeed, state.rules.roast);
+
+            state.previousPlatformScroll = state.platformScroll;
+            if (pool.worldWidth > 0.0f) {
+                state.platformScroll += state.rules.swarmScrollSpeed * deltaTime;
+                if (state.platformScroll >= pool.worldWidth) {
+                    state.platformScroll -= pool.worldWidth;
+                    state.previousPlatformScroll -= pool.worldWidth;
+                }
+            }
+
+            if (input.mousePressed) {
+                int i = FindMarshmallowAt(pool, input.mouseX + state.platformScroll, input.mouseY);
+                if (i >= 0) {
+                    state.score += state.rules.points[pool.state[i]];
+                    if (pool.state[i] == 3) state.events |= GAME_EVENT_BURN;
+                    else if (pool.state[i] != 0) state.events |= GAME_EVENT_CLICK;
+                    ResetMarshmallow(pool, i);
+                }
+            }
+
+            if (state.mode == TIMED) {
+                state.timeRemaining -= deltaTime;
+            }
+
+            if (state.score >= state.winScore || (state.mode == TIMED && state.timeRemaining <= 0)) {
+                state.screen = ENDING;
+                state.leaderboardMode = state.mode;  // The ending screen shows this mode's table
+                state.events |= GAME_EVENT_GAME_OVER;
+            }
+            break;
+        }
+
+        case ENDING:
+            if (input.keys & GAME_KEY_ENTER) {
+                state.screen = TITLE;
+            }
+            break;
+    }
+}
+
+int GameAdvance(GameState &state, const GameInput &input, float frameTime) {
+    // Signals are levels and stay set; presses are edges, queued per frame so two
+    // frames between steps still give two steps a key or a click each
+    const unsigned int signalMask = GAME_SIGNAL_TITLE_READY | GAME_SIGNAL_GAMEPLAY_READY;
+    GameInput &held = state.heldInput;
+    held.keys |= input.keys & signalMask;
+    held.mouseX = input.mouseX;
+    held.mouseY = input.mouseY;
+    if ((input.keys & ~signalMask) != 0 || input.keyPressed != 0 || input.mousePressed) {
+        if (state.queuedInputCount < GAME_INPUT_QUEUE_MAX) {
+            state.queuedInput[state.queuedInputCount++] = input;
+        } else {
+            // Queue full (a very long stall between steps): merge into the newest frame
+            GameInput &last = state.queuedInput[GAME_INPUT_QUEUE_MAX - 1];
+            last.keys |= input.keys;
+            if (input.keyPressed != 0) last.keyPressed = input.keyPressed;
+            if (input.mousePressed && !last.mousePressed) {
+                last.mousePressed = true;
+                last.mouseX = input.mouseX;
+                last.mouseY = input.mouseY;
+            }
+        }
+    }
+
+    state.accumulator += (frameTime < GAME_MAX_FRAME_TIME) ? frameTime : GAME_MAX_FRAME_TIME;
+
+    unsigned int events = 0;
+    int steps = 0;
+    while (state.accumulator >= GAME_STEP_DT) {
+        GameInput stepInput = held;
+        if (state.queuedInputCount > 0) {
+            const GameInput &queued = state.queuedInput[0];
+            stepInput.keys |= queued.keys;
+            stepInput.keyPressed = queued.keyPressed;
+            if (queued.mousePressed) {
+                stepInput.mousePressed = true;
+                stepInput.mouseX = queued.mouseX;
+                stepInput.mouseY = queued.mouseY;
+            }
+            state.queuedInputCount--;
+            memmove(&state.queuedInput[0], &state.queuedInput[1], state.queuedInputCount * sizeof(GameInput));
+        }
+        GameStep(state, stepInput, GAME_STEP_DT);
+        events |= state.events;
+        state.accumulator -= GAME_STEP_DT;
+        steps++;
+    }
+    state.events = events;
+    return steps;
+}
+
+float GetGameStepAlpha(const GameState &state) {
+    return state.accumulator / GAME_STEP_DT;
+}
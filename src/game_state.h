@@ -0,0 +1,123 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "game_modes.h"
+#include "marshmallow_pool.h"
+
+//----------------------------------------------------------------------------------
+// Simulation core: everything the game decides, nothing it draws or plays.
+// No raylib dependency, so it runs headless for benchmarks, replays and tuning.
+//----------------------------------------------------------------------------------
+
+// Define game screens
+typedef enum GameScreen { LOGO = 0, TITLE, INSTRUCTIONS, MODE_SELECT, NAME_INPUT, GAMEPLAY, ENDING, LEADERBOARD_SELECTION } GameScreen;
+#define GAME_SCREEN_COUNT 8
+
+// Keys the simulation reacts to, as bits in GameInput::keys
+enum {
+    GAME_KEY_ENTER     = 1 << 0,
+    GAME_KEY_BACKSPACE = 1 << 1,
+    GAME_KEY_L         = 1 << 2,
+    GAME_KEY_ONE       = 1 << 3,
+    GAME_KEY_TWO       = 1 << 4,
+    GAME_KEY_THREE     = 1 << 5,
+    GAME_KEY_FOUR      = 1 << 6,
+
+    // Not keys: the platform layer sets these every frame once the asset loader
+    // has finished a group, so loading is part of the recorded input and replays
+    // leave the LOGO screen on the same frame as the recorded run
+    GAME_SIGNAL_TITLE_READY    = 1 << 7,    // Title screen assets uploaded, LOGO may advance
+    GAME_SIGNAL_GAMEPLAY_READY = 1 << 8,    // Sprites and sounds uploaded, a mode may be picked
+
+    GAME_KEY_FIVE      = 1 << 9,
+};
+
+// Side effects raised by GameStep(), as bits in GameState::events (cleared every step)
+enum {
+    GAME_EVENT_CLICK               = 1 << 0,    // Yellow or brown marshmallow collected
+    GAME_EVENT_BURN                = 1 << 1,    // Burnt marshmallow clicked
+    GAME_EVENT_GAME_OVER           = 1 << 2,    // Entered ENDING, score is final
+    GAME_EVENT_LEADERBOARD_CHANGED = 1 << 3,    // leaderboardMode was selected
+};
+
+// One frame of input, sampled by the platform layer
+struct GameInput {
+    unsigned int keys;      // GAME_KEY_* pressed this frame, plus GAME_SIGNAL_* state
+    int keyPressed;         // Key code from the key queue (raylib GetKeyPressed()), 0 if none
+    bool mousePressed;      // Left button pressed this frame
+    float mouseX;
+    float mouseY;
+};
+
+// Difficulty constants, per mode where they differ
+struct GameRules {
+    float roastingSpeed[GAME_MODE_COUNT];
+    int winScore[GAME_MODE_COUNT];
+    float timeLimit;            // Seconds per TIMED game
+    MarshmallowThresholds roast;
+    int points[4];              // Score for clicking a white/yellow/brown/burnt marshmallow
+
+    // SWARM: rows of marshmallows on a platform that scrolls left and wraps around
+    int swarmCount;
+    int swarmRows;
+    float swarmSpacing;         // Between neighbours in a row
+    float swarmScrollSpeed;     // Pixels per second
+};
+
+extern const GameRules DEFAULT_GAME_RULES;
+
+// The simulation always advances in steps of GAME_STEP_DT, whatever the frame rate.
+// Frame time beyond GAME_MAX_FRAME_TIME is dropped, so after a long hitch the game
+// slows down instead of running dozens of catch-up steps.
+#define GAME_STEP_HZ 120
+#define GAME_STEP_DT (1.0f / GAME_STEP_HZ)
+#define GAME_MAX_FRAME_TIME 0.25f
+#define GAME_INPUT_QUEUE_MAX 8          // Frames with presses waiting for a step, more merge into the last
+
+#define MARSHMALLOW_COUNT 4         // Classic modes: two platforms, a marshmallow at each end
+#define SWARM_TOP 150               // y of the first SWARM row
+#define SWARM_ROW_HEIGHT 110
+#define SWARM_MIN_WORLD_WIDTH 1024  // Wider than the screen plus a marshmallow, so nothing is drawn twice
+
+struct GameState {
+    GameRules rules;
+    GameScreen screen;
+    GameMode mode;
+    GameMode leaderboardMode;   // Mode picked on LEADERBOARD_SELECTION
+    bool displayLeaderboard;
+    float roastingSpeed;
+    float timeRemaining;
+    float previousTimeRemaining;    // Before the last step, for interpolated display
+    int winScore;
+    int score;
+    int letterCount;
+    char playerName[32];
+    MarshmallowPool marshmallows;   // Laid out for the current mode when it's picked
+    float platformScroll;           // SWARM: world x at the left edge of the screen
+    float previousPlatformScroll;   // Before the last step, for interpolated display
+    unsigned int events;        // GAME_EVENT_* raised by the last step (by all steps of the last GameAdvance)
+
+    // Fixed-step bookkeeping for GameAdvance()
+    float accumulator;          // Frame time not yet simulated, less than GAME_STEP_DT
+    GameInput heldInput;        // Signals seen so far and the latest pointer position, no presses
+    GameInput queuedInput[GAME_INPUT_QUEUE_MAX];    // Frames whose presses no step has seen yet, oldest first
+    int queuedInputCount;
+};
+
+const char *GetGameScreenString(GameScreen screen);
+
+// GameState is large (the marshmallow pool); keep it in static or heap storage
+void InitGameState(GameState &state, const GameRules &rules);
+
+// Advance the simulation by one step
+void GameStep(GameState &state, const GameInput &input, float deltaTime);
+
+// Advance by one frame of real time in fixed GAME_STEP_DT steps; returns the number
+// of steps run, possibly 0. A frame's key presses and click reach exactly one step;
+// when frames come faster than steps they queue up and each step takes the oldest.
+int GameAdvance(GameState &state, const GameInput &input, float frameTime);
+
+// How far the accumulator is into the next step, 0.0 .. 1.0, for render interpolation
+float GetGameStepAlpha(const GameState &state);
+
+#endif // GAME_STATE_H
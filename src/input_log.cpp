@@ -0,0 +1,104 @@
+#include "input_log.h"
+#include <cstdint>
+#include <cstring>
+
+static const char INPUT_LOG_MAGIC[4] = { 'M', 'G', 'I', 'N' };
+static const uint32_t INPUT_LOG_VERSION = 3;   // 2: starts on LOGO, keys carry GAME_SIGNAL_* bits; 3: fixed-step replay
+
+// Record flags
+enum {
+    FRAME_KEYS          = 1 << 0,
+    FRAME_KEY_PRESSED   = 1 << 1,
+    FRAME_MOUSE_MOVED   = 1 << 2,
+    FRAME_MOUSE_PRESSED = 1 << 3,
+};
+
+bool OpenInputRecording(InputLog &log, const char *path) {
+    log = InputLog();
+    log.file = fopen(path, "wb");
+    if (log.file == nullptr) return false;
+    log.writing = true;
+
+    fwrite(INPUT_LOG_MAGIC, 1, sizeof(INPUT_LOG_MAGIC), log.file);
+    fwrite(&INPUT_LOG_VERSION, sizeof(INPUT_LOG_VERSION), 1, log.file);
+    return true;
+}
+
+void RecordInputFrame(InputLog &log, const GameInput &input, float deltaTime) {
+    if (log.file == nullptr || !log.writing) return;
+
+    uint8_t flags = 0;
+    if (input.keys != 0) flags |= FRAME_KEYS;
+    if (input.keyPressed != 0) flags |= FRAME_KEY_PRESSED;
+    if (input.mouseX != log.last.mouseX || input.mouseY != log.last.mouseY) flags |= FRAME_MOUSE_MOVED;
+    if (input.mousePressed) flags |= FRAME_MOUSE_PRESSED;
+
+    fwrite(&flags, sizeof(flags), 1, log.file);
+    fwrite(&deltaTime, sizeof(deltaTime), 1, log.file);
+    if (flags & FRAME_KEYS) {
+        uint32_t keys = input.keys;
+        fwrite(&keys, sizeof(keys), 1, log.file);
+    }
+    if (flags & FRAME_KEY_PRESSED) {
+        int32_t key = input.keyPressed;
+        fwrite(&key, sizeof(key), 1, log.file);
+    }
+    if (flags & FRAME_MOUSE_MOVED) {
+        fwrite(&input.mouseX, sizeof(input.mouseX), 1, log.file);
+        fwrite(&input.mouseY, sizeof(input.mouseY), 1, log.file);
+    }
+
+    log.last = input;
+    log.frames++;
+}
+
+bool OpenInputReplay(InputLog &log, const char *path) {
+    log = InputLog();
+    log.file = fopen(path, "rb");
+    if (log.file == nullptr) return false;
+
+    char magic[4];
+    uint32_t version = 0;
+    if (fread(magic, 1, sizeof(magic), log.file) != sizeof(magic) || memcmp(magic, INPUT_LOG_MAGIC, sizeof(magic)) != 0 ||
+        fread(&version, sizeof(version), 1, log.file) != 1 || version != INPUT_LOG_VERSION) {
+        CloseInputLog(log);
+        return false;
+    }
+    return true;
+}
+
+bool ReadInputFrame(InputLog &log, GameInput &input, float &deltaTime) {
+    if (log.file == nullptr || log.writing) return false;
+
+    uint8_t flags;
+    if (fread(&flags, sizeof(flags), 1, log.file) != 1) return false;
+    if (fread(&deltaTime, sizeof(deltaTime), 1, log.file) != 1) return false;
+
+    input = GameInput();
+    input.mouseX = log.last.mouseX;
+    input.mouseY = log.last.mouseY;
+    if (flags & FRAME_KEYS) {
+        uint32_t keys;
+        if (fread(&keys, sizeof(keys), 1, log.file) != 1) return false;
+        input.keys = keys;
+    }
+    if (flags & FRAME_KEY_PRESSED) {
+        int32_t key;
+        if (fread(&key, sizeof(key), 1, log.file) != 1) return false;
+        input.keyPressed = key;
+    }
+    if (flags & FRAME_MOUSE_MOVED) {
+        if (fread(&input.mouseX, sizeof(input.mouseX), 1, log.file) != 1) return false;
+        if (fread(&input.mouseY, sizeof(input.mouseY), 1, log.file) != 1) return false;
+    }
+    input.mousePressed = (flags & FRAME_MOUSE_PRESSED) != 0;
+
+    log.last = input;
+    log.frames++;
+    return true;
+}
+
+void CloseInputLog(InputLog &log) {
+    if (log.file != nullptr) fclose(log.file);
+    log.file = nullptr;
+}
@@ -0,0 +1,33 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include "game_state.h"
+#include <cstdio>
+
+//----------------------------------------------------------------------------------
+// Input record/replay
+//----------------------------------------------------------------------------------
+// Every frame's GameInput and frame time go to a compact binary log. Feeding the
+// log back through GameStep() reproduces the session exactly, with or without a window.
+//
+// File layout: "MGIN" magic, uint32 version, then one record per frame:
+//   uint8 flags, float32 deltaTime, then only the fields flagged as changed since
+//   the previous frame (uint32 keys, int32 keyPressed, float32 mouseX, mouseY).
+// An idle frame costs 5 bytes.
+
+struct InputLog {
+    FILE *file;
+    bool writing;
+    GameInput last;         // Previous frame, fields are delta-encoded against it
+    long frames;
+};
+
+bool OpenInputRecording(InputLog &log, const char *path);
+void RecordInputFrame(InputLog &log, const GameInput &input, float deltaTime);
+
+bool OpenInputReplay(InputLog &log, const char *path);
+bool ReadInputFrame(InputLog &log, GameInput &input, float &deltaTime);    // False at end of log
+
+void CloseInputLog(InputLog &log);
+
+#endif // INPUT_LOG_H
@@ -0,0 +1,93 @@
+#include "leaderboard.h"
+#include <cstring>
+
+// Write-through update of a resident top-N table
+bool InsertLeaderboardEntry(LeaderboardTable &table, const char *name, int score, float time) {
+    int existing = -1;
+    for (int i = 0; i < table.count; i++) {
+        if (strncmp(table.entries[i].name, name, sizeof(table.entries[i].name)) == 0) {
+            existing = i;
+            break;
+        }
+    }
+
+    if (existing >= 0) {
+        if (score <= table.entries[existing].score) return false;
+        // Drop the old row, it is re-inserted at its new rank below
+        memmove(&table.entries[existing], &table.entries[existing + 1], (table.count - existing - 1) * sizeof(LeaderboardEntry));
+        table.count--;
+    } else if (table.count == LEADERBOARD_TOP_N && score <= table.entries[LEADERBOARD_TOP_N - 1].score) {
+        return false;
+    }
+
+    // Rank after any equal scores, the lowest row falls off a full table
+    int rank = 0;
+    while (rank < table.count && table.entries[rank].score >= score) rank++;
+    int moved = ((table.count < LEADERBOARD_TOP_N) ? table.count : LEADERBOARD_TOP_N - 1) - rank;
+    if (moved > 0) memmove(&table.entries[rank + 1], &table.entries[rank], moved * sizeof(LeaderboardEntry));
+    if (table.count < LEADERBOARD_TOP_N) table.count++;
+
+    LeaderboardEntry &entry = table.entries[rank];
+    strncpy(entry.name, name, sizeof(entry.name) - 1);
+    entry.name[sizeof(entry.name) - 1] = '\0';
+    entry.score = score;
+    entry.time = time;
+    entry.mode = table.mode;
+    return true;
+}
+
+#if defined(PLATFORM_WEB)
+static const LeaderboardStorage *storage = &JOURNAL_STORAGE;
+#else
+static const LeaderboardStorage *storage = &SQLITE_STORAGE;
+#endif
+
+void SetLeaderboardStorage(const LeaderboardStorage *newStorage) {
+    storage = newStorage;
+}
+
+const LeaderboardStorage *GetLeaderboardStorage(void) {
+    return storage;
+}
+
+const LeaderboardStorage *GetLeaderboardStorageFor(const char *path) {
+    size_t length = strlen(path), extLength = strlen(LEADERBOARD_JOURNAL_EXT);
+    if (length >= extLength && strcmp(path + length - extLength, LEADERBOARD_JOURNAL_EXT) == 0) return &JOURNAL_STORAGE;
+#if defined(PLATFORM_WEB)
+    return &JOURNAL_STORAGE;
+#else
+    return &SQLITE_STORAGE;
+#endif
+}
+
+bool InitDatabase(const char *path) {
+    return storage->open(path);
+}
+
+const char *GetDatabaseError(void) {
+    return storage->getError();
+}
+
+void CloseDatabase(void) {
+    storage->close();
+}
+
+ScoreInsertResult InsertScore(const char *name, int score, float time, GameMode mode) {
+    return storage->insertScore(name, score, time, mode);
+}
+
+bool BeginScoreBatch(void) {
+    return storage->beginBatch();
+}
+
+bool CommitScoreBatch(void) {
+    return storage->commitBatch();
+}
+
+void RollbackScoreBatch(void) {
+    storage->rollbackBatch();
+}
+
+void LoadLeaderboard(GameMode mode, LeaderboardTable &table) {
+    storage->loadTop(mode, table);
+}
@@ -0,0 +1,83 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include "game_modes.h"
+
+// Number of rows kept per mode on the leaderboard
+#define LEADERBOARD_TOP_N 5
+#define LEADERBOARD_JOURNAL_EXT ".journal"
+
+// Leaderboard structure, fixed-size so tables copy without allocating
+struct LeaderboardEntry {
+    char name[32];
+    int score;
+    float time;
+    GameMode mode;
+};
+
+// Top scores for one mode, best first
+struct LeaderboardTable {
+    GameMode mode;
+    int count;
+    LeaderboardEntry entries[LEADERBOARD_TOP_N];
+};
+
+// Apply a finished game to a resident table with the same rules as InsertScore
+// (one row per name, only a better score replaces it). True if the table changed.
+bool InsertLeaderboardEntry(LeaderboardTable &table, const char *name, int score, float time);
+
+//----------------------------------------------------------------------------------
+// Leaderboard storage
+//----------------------------------------------------------------------------------
+// The functions below go to the storage selected with SetLeaderboardStorage(),
+// by default SQLITE_STORAGE on desktop and JOURNAL_STORAGE on the web (which
+// doesn't link SQLite). Both keep each player's best score per mode. No raylib
+// dependency so the persistence worker and offline tools can share it; safe to
+// call from the worker and render threads.
+// What InsertScore did with a score
+typedef enum ScoreInsertResult {
+    SCORE_INSERT_FAILED = -1,   // Storage error (GetDatabaseError() says which), nothing recorded
+    SCORE_NOT_IMPROVED = 0,     // Not better than the player's stored best
+    SCORE_NEW_BEST = 1,
+} ScoreInsertResult;
+
+struct LeaderboardStorage {
+    const char *name;
+    bool (*open)(const char *path);
+    void (*close)(void);
+    const char *(*getError)(void);
+    ScoreInsertResult (*insertScore)(const char *name, int score, float time, GameMode mode);
+    bool (*beginBatch)(void);
+    bool (*commitBatch)(void);
+    void (*rollbackBatch)(void);
+    void (*loadTop)(GameMode mode, LeaderboardTable &table);
+};
+
+#if !defined(PLATFORM_WEB)
+extern const LeaderboardStorage SQLITE_STORAGE;     // leaderboard_sqlite.cpp
+#endif
+extern const LeaderboardStorage JOURNAL_STORAGE;    // leaderboard_journal.cpp
+
+void SetLeaderboardStorage(const LeaderboardStorage *storage);     // Before InitDatabase()
+const LeaderboardStorage *GetLeaderboardStorage(void);
+
+// The journal for paths ending in LEADERBOARD_JOURNAL_EXT, otherwise the default
+const LeaderboardStorage *GetLeaderboardStorageFor(const char *path);
+
+bool InitDatabase(const char *path);            // Open (creating if needed) the storage, false on failure
+const char *GetDatabaseError(void);             // Last error message reported by the storage
+void CloseDatabase(void);
+
+// Insert or update a player's best score for a mode
+ScoreInsertResult InsertScore(const char *name, int score, float time, GameMode mode);
+
+// Wrap a run of InsertScore calls in a single transaction. After a failed insert or
+// commit, RollbackScoreBatch() discards what the storage doesn't have on disk.
+bool BeginScoreBatch(void);
+bool CommitScoreBatch(void);
+void RollbackScoreBatch(void);
+
+// Load the top scores for a mode into table
+void LoadLeaderboard(GameMode mode, LeaderboardTable &table);
+
+#endif // LEADERBOARD_H
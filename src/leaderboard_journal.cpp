@@ -0,0 +1,349 @@
+//----------------------------------------------------------------------------------
+// Journal leaderboard storage
+//----------------------------------------------------------------------------------
+// An append-only file of fixed-size records, one per new personal best. Opening
+// it is a single streaming pass that rebuilds best-per-(name, mode) and the top N
+// of every mode in memory; after that a read is a copy and a write is one fwrite,
+// flushed at commit.
+//
+// Once the journal holds JOURNAL_COMPACT_RATIO times more records than there are
+// live bests, it is rewritten with just the live ones to a temporary file on a
+// background thread (inline on the web) and renamed over the journal. Records
+// appended meanwhile are copied across before the swap.
+//
+// On PLATFORM_WEB the file lives under the IDBFS mount that shell.html loads
+// before main() runs, and every commit asks the page to sync it to IndexedDB.
+#include "leaderboard.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+#else
+    #include <thread>
+#endif
+
+#define JOURNAL_COMPACT_MIN 4096        // Records, shorter journals are never compacted
+#define JOURNAL_COMPACT_RATIO 2
+#define JOURNAL_READ_CHUNK 1024         // Records read per fread() when opening
+
+static const char JOURNAL_MAGIC[4] = { 'M', 'G', 'L', 'J' };
+static const uint32_t JOURNAL_VERSION = 1;
+
+struct JournalHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+struct JournalRecord {
+    char name[32];
+    int32_t score;
+    float time;
+    int32_t mode;
+};
+
+struct BestScore {
+    int score;
+    float time;
+};
+
+// Everything below is guarded by journalMutex
+static std::mutex journalMutex;
+static FILE *journal = nullptr;
+static std::string journalPath;
+static std::string lastError = "journal not opened";
+static std::unordered_map<std::string, BestScore> best[GAME_MODE_COUNT];
+static LeaderboardTable tops[GAME_MODE_COUNT];
+static long journalRecords = 0;         // Records in the file
+static long liveRecords = 0;            // Entries in best[]
+static bool batching = false;
+
+static bool compacting = false;
+static std::vector<JournalRecord> compactTail;  // Appended while a compaction is writing
+#if !defined(PLATFORM_WEB)
+static std::thread compactor;
+#endif
+
+// Ask the page to copy the IDBFS mount back to IndexedDB (no-op on desktop)
+static void PersistJournal(void) {
+#if defined(PLATFORM_WEB)
+    EM_ASM({ if (Module.syncPersistentFiles) Module.syncPersistentFiles(); });
+#endif
+}
+
+// Fold one record into the in-memory state, true if it is a new best
+static bool ApplyRecord(JournalRecord &record) {
+    if (record.mode < 0 || record.mode >= GAME_MODE_COUNT) return false;
+    record.name[sizeof(record.name) - 1] = '\0';
+
+    std::pair<std::unordered_map<std::string, BestScore>::iterator, bool> slot =
+        best[record.mode].insert(std::make_pair(std::string(record.name), BestScore()));
+    if (slot.second) {
+        liveRecords++;
+    } else if (record.score <= slot.first->second.score) {
+        return false;
+    }
+    slot.first->second.score = record.score;
+    slot.first->second.time = record.time;
+    InsertLeaderboardEntry(tops[record.mode], record.name, record.score, record.time);
+    return true;
+}
+
+// Whether ApplyRecord() would take the record, without changing anything
+static bool IsNewBest(const JournalRecord &record) {
+    if (record.mode < 0 || record.mode >= GAME_MODE_COUNT) return false;
+    std::unordered_map<std::string, BestScore>::const_iterator it = best[record.mode].find(record.name);
+    return it == best[record.mode].end() || record.score > it->second.score;
+}
+
+static std::vector<JournalRecord> CollectLiveRecords(void) {
+    std::vector<JournalRecord> records;
+    records.reserve(liveRecords);
+    for (int m = 0; m < GAME_MODE_COUNT; m++) {
+        for (std::unordered_map<std::string, BestScore>::const_iterator it = best[m].begin(); it != best[m].end(); ++it) {
+            JournalRecord record;
+            memset(&record, 0, sizeof(record));
+            strncpy(record.name, it->first.c_str(), sizeof(record.name) - 1);
+            record.score = it->second.score;
+            record.time = it->second.time;
+            record.mode = m;
+            records.push_back(record);
+        }
+    }
+    return records;
+}
+
+// Header and records to a new file; needs no lock
+static bool WriteJournalFile(const std::string &fileName, const std::vector<JournalRecord> &records) {
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr) return false;
+    JournalHeader header;
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    header.recordSize = sizeof(JournalRecord);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (records.empty() || fwrite(records.data(), sizeof(JournalRecord), records.size(), file) == records.size());
+    return (fclose(file) == 0) && ok;
+}
+
+// Finish a compaction written to tempName: add the tail and rename it over the journal (lock held)
+static bool SwapInJournal(const std::string &tempName, long records) {
+    FILE *file = fopen(tempName.c_str(), "ab");
+    bool ok = file != nullptr &&
+              (compactTail.empty() || fwrite(compactTail.data(), sizeof(JournalRecord), compactTail.size(), file) == compactTail.size());
+    if (file != nullptr && fclose(file) != 0) ok = false;
+
+    if (journal != nullptr) fclose(journal);
+#if defined(_WIN32)
+    if (ok) remove(journalPath.c_str());    // rename() won't replace an existing file there
+#endif
+    ok = ok && rename(tempName.c_str(), journalPath.c_str()) == 0;
+    if (ok) journalRecords = records + (long)compactTail.size();
+    else remove(tempName.c_str());
+    compactTail.clear();
+
+    journal = fopen(journalPath.c_str(), "ab");
+    if (journal == nullptr) lastError = std::string("can't reopen journal: ") + strerror(errno);
+    PersistJournal();
+    return ok && journal != nullptr;
+}
+
+#if !defined(PLATFORM_WEB)
+static void CompactInBackground(std::vector<JournalRecord> live, std::string tempName) {
+    bool written = WriteJournalFile(tempName, live);
+    std::lock_guard<std::mutex> lock(journalMutex);
+    if (written) SwapInJournal(tempName, (long)live.size());
+    else compactTail.clear();
+    compacting = false;
+}
+#endif
+
+// Start a compaction if the journal has grown enough past the live records (lock held)
+static void MaybeCompactJournal(void) {
+    if (compacting || journalRecords < JOURNAL_COMPACT_MIN || journalRecords <= JOURNAL_COMPACT_RATIO * liveRecords) return;
+
+    std::vector<JournalRecord> live = CollectLiveRecords();
+    std::string tempName = journalPath + ".tmp";
+#if defined(PLATFORM_WEB)
+    if (WriteJournalFile(tempName, live)) SwapInJournal(tempName, (long)live.size());
+#else
+    compacting = true;
+    if (compactor.joinable()) compactor.join();     // The previous one is done, compacting was false
+    compactor = std::thread(CompactInBackground, std::move(live), tempName);
+#endif
+}
+
+static void ResetJournalState(void) {
+    for (int m = 0; m < GAME_MODE_COUNT; m++) {
+        best[m].clear();
+        tops[m].mode = (GameMode)m;
+        tops[m].count = 0;
+    }
+    journalRecords = liveRecords = 0;
+    batching = false;
+    compactTail.clear();
+}
+
+// Rebuild the in-memory state from the file and open it for appending (lock held)
+static bool LoadJournal(const char *path) {
+    ResetJournalState();
+    journalPath = path;
+
+    // One pass over the file; a new or empty file, or a torn last record, gets rewritten clean
+    bool rewrite = true;
+    FILE *file = fopen(path, "rb");
+    if (file != nullptr) {
+        JournalHeader header;
+        if (fread(&header, sizeof(header), 1, file) == 1) {
+            if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 || header.version != JOURNAL_VERSION ||
+                header.recordSize != sizeof(JournalRecord)) {
+                fclose(file);
+                lastError = "not a leaderboard journal, or from a newer version";
+                return false;
+            }
+            static JournalRecord chunk[JOURNAL_READ_CHUNK];
+            size_t count;
+            while ((count = fread(chunk, sizeof(JournalRecord), JOURNAL_READ_CHUNK, file)) > 0) {
+                for (size_t i = 0; i < count; i++) ApplyRecord(chunk[i]);
+                journalRecords += (long)count;
+            }
+            fseek(file, 0, SEEK_END);
+            rewrite = ftell(file) != (long)(sizeof(header) + journalRecords * sizeof(JournalRecord));
+        }
+        fclose(file);
+    }
+
+    if (rewrite) {
+        std::string tempName = journalPath + ".tmp";
+        std::vector<JournalRecord> live = CollectLiveRecords();
+        if (!WriteJournalFile(tempName, live)) {
+            lastError = std::string("can't write journal: ") + strerror(errno);
+            return false;
+        }
+        if (!SwapInJournal(tempName, (long)live.size())) {
+            if (journal == nullptr) return false;   // lastError says why
+            lastError = std::string("can't replace journal: ") + strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    journal = fopen(path, "ab");
+    if (journal == nullptr) {
+        lastError = std::string("can't open journal: ") + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+static bool OpenJournalStorage(const char *path) {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    return LoadJournal(path);
+}
+
+// After a failed write: part of a record may be in the file, so stop appending to it and
+// reload, which rewrites a torn tail and brings memory back in line with the disk. A
+// running compaction replaces the file and reopens it by itself (lock held).
+static void RecoverJournal(void) {
+    if (journal != nullptr) fclose(journal);
+    journal = nullptr;
+    if (compacting) return;
+    bool wasBatching = batching;
+    std::string path = journalPath;
+    LoadJournal(path.c_str());
+    batching = wasBatching;
+}
+
+static const char *GetJournalError(void) {
+    return lastError.c_str();
+}
+
+static void CloseJournalStorage(void) {
+#if !defined(PLATFORM_WEB)
+    if (compactor.joinable()) compactor.join();     // It takes the lock to finish
+#endif
+    std::lock_guard<std::mutex> lock(journalMutex);
+    if (journal != nullptr) {
+        fclose(journal);
+        PersistJournal();
+    }
+    journal = nullptr;
+    ResetJournalState();
+}
+
+static ScoreInsertResult InsertJournalScore(const char *name, int score, float time, GameMode mode) {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    JournalRecord record;
+    memset(&record, 0, sizeof(record));
+    strncpy(record.name, name, sizeof(record.name) - 1);
+    record.score = score;
+    record.time = time;
+    record.mode = mode;
+    if (!IsNewBest(record)) return SCORE_NOT_IMPROVED;     // Nothing to write
+
+    // On disk first: memory only ever holds what the journal does
+    if (journal == nullptr) return SCORE_INSERT_FAILED;     // lastError says why
+    if (fwrite(&record, sizeof(record), 1, journal) != 1) {
+        lastError = std::string("journal write failed: ") + strerror(errno);
+        RecoverJournal();
+        return SCORE_INSERT_FAILED;
+    }
+    ApplyRecord(record);
+    journalRecords++;
+    if (compacting) compactTail.push_back(record);
+    if (!batching) {
+        fflush(journal);
+        PersistJournal();
+        MaybeCompactJournal();
+    }
+    return SCORE_NEW_BEST;
+}
+
+static bool BeginJournalBatch(void) {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    batching = true;
+    return journal != nullptr;
+}
+
+static bool CommitJournalBatch(void) {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    batching = false;
+    if (journal == nullptr) return false;
+    bool ok = fflush(journal) == 0;
+    PersistJournal();
+    MaybeCompactJournal();
+    return ok;
+}
+
+// Records are applied only once written, so this only has to drop whatever a failed
+// flush may have left half on disk
+static void RollbackJournalBatch(void) {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    batching = false;
+    RecoverJournal();
+}
+
+static void LoadJournalLeaderboard(GameMode mode, LeaderboardTable &table) {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    table = tops[mode];
+    table.mode = mode;
+}
+
+const LeaderboardStorage JOURNAL_STORAGE = {
+    "journal",
+    OpenJournalStorage,
+    CloseJournalStorage,
+    GetJournalError,
+    InsertJournalScore,
+    BeginJournalBatch,
+    CommitJournalBatch,
+    RollbackJournalBatch,
+    LoadJournalLeaderboard,
+};
@@ -0,0 +1,183 @@
+#include "leaderboard_net.h"
+#include <cstring>
+
+#if !defined(PLATFORM_WEB) && !defined(_WIN32)
+    #define LEADERBOARD_NET_SOCKETS
+    #include <cerrno>
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+static_assert(sizeof(NetScore) == 44, "NetScore is a wire record");
+static_assert(sizeof(NetTable) == 8 + 44 * LEADERBOARD_TOP_N, "NetTable is a wire record");
+
+int GetNetMessageSize(const char *data, int size) {
+    if (size < (int)sizeof(NetHeader)) return 0;
+    NetHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    int length = 0;
+    switch (header.type) {
+        case NET_MSG_SUBMIT:
+            if (header.count > NET_SUBMIT_MAX) return -1;
+            length = sizeof(NetHeader) + header.count * sizeof(NetScore);
+            break;
+        case NET_MSG_SUBSCRIBE:
+        case NET_MSG_ACK:
+            length = sizeof(NetHeader);
+            break;
+        case NET_MSG_TABLE:
+            if (header.count != 1) return -1;
+            length = sizeof(NetHeader) + sizeof(NetTable);
+            break;
+        default:
+            return -1;
+    }
+    return (size >= length) ? length : 0;
+}
+
+NetScore MakeNetScore(const char *name, int score, float time, GameMode mode) {
+    NetScore net;
+    memset(&net, 0, sizeof(net));
+    strncpy(net.name, name, sizeof(net.name) - 1);
+    net.score = score;
+    net.time = time;
+    net.mode = mode;
+    return net;
+}
+
+NetTable MakeNetTable(const LeaderboardTable &table) {
+    NetTable net;
+    memset(&net, 0, sizeof(net));
+    net.mode = table.mode;
+    net.count = table.count;
+    for (int i = 0; i < table.count; i++) {
+        net.entries[i] = MakeNetScore(table.entries[i].name, table.entries[i].score, table.entries[i].time, table.mode);
+    }
+    return net;
+}
+
+bool ReadNetTable(const NetTable &net, LeaderboardTable &table) {
+    if (net.mode < 0 || net.mode >= GAME_MODE_COUNT || net.count < 0 || net.count > LEADERBOARD_TOP_N) return false;
+    table.mode = (GameMode)net.mode;
+    table.count = net.count;
+    for (int i = 0; i < net.count; i++) {
+        LeaderboardEntry &entry = table.entries[i];
+        memcpy(entry.name, net.entries[i].name, sizeof(entry.name));
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        entry.score = net.entries[i].score;
+        entry.time = net.entries[i].time;
+        entry.mode = table.mode;
+    }
+    return true;
+}
+
+#if defined(LEADERBOARD_NET_SOCKETS)
+bool OpenNetConnection(NetConnection &connection, int port) {
+    connection.inboxSize = 0;
+    connection.socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (connection.socket < 0) return false;
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(connection.socket, (const sockaddr *)&address, sizeof(address)) != 0) {
+        CloseNetConnection(connection);
+        return false;
+    }
+
+    // Batches are already coalesced by the caller, don't hold them back for Nagle
+    int noDelay = 1;
+    setsockopt(connection.socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return true;
+}
+
+void CloseNetConnection(NetConnection &connection) {
+    if (connection.socket >= 0) close(connection.socket);
+    connection.socket = -1;
+    connection.inboxSize = 0;
+}
+
+static bool SendAll(NetConnection &connection, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(connection.socket, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) {
+            CloseNetConnection(connection);
+            return false;
+        }
+        data += sent;
+        size -= (size_t)sent;
+    }
+    return true;
+}
+
+bool SendNetScores(NetConnection &connection, const NetScore *scores, int count) {
+    if (connection.socket < 0 || count <= 0 || count > NET_SUBMIT_MAX) return false;
+
+    // Header and records in one send, so each batch is one segment on the wire
+    char message[sizeof(NetHeader) + NET_SUBMIT_MAX * sizeof(NetScore)];
+    NetHeader header = { NET_MSG_SUBMIT, (uint32_t)count };
+    memcpy(message, &header, sizeof(header));
+    memcpy(message + sizeof(header), scores, count * sizeof(NetScore));
+    return SendAll(connection, message, sizeof(header) + count * sizeof(NetScore));
+}
+
+bool SendNetSubscribe(NetConnection &connection) {
+    if (connection.socket < 0) return false;
+    NetHeader header = { NET_MSG_SUBSCRIBE, 0 };
+    return SendAll(connection, (const char *)&header, sizeof(header));
+}
+
+// Take the first complete message out of the inbox, false if there isn't one
+static bool PopNetMessage(NetConnection &connection, NetMessage &message, bool &malformed) {
+    int size = GetNetMessageSize(connection.inbox, connection.inboxSize);
+    malformed = size < 0;
+    if (size <= 0) return false;
+
+    NetHeader header;
+    memcpy(&header, connection.inbox, sizeof(header));
+    message.type = (NetMessageType)header.type;
+    message.count = (int)header.count;
+    if (message.type == NET_MSG_TABLE) memcpy(&message.table, connection.inbox + sizeof(header), sizeof(message.table));
+
+    connection.inboxSize -= size;
+    memmove(connection.inbox, connection.inbox + size, connection.inboxSize);
+    return true;
+}
+
+int ReceiveNetMessage(NetConnection &connection, NetMessage &message, int timeoutMs) {
+    if (connection.socket < 0) return -1;
+    bool malformed = false;
+    for (;;) {
+        if (PopNetMessage(connection, message, malformed)) return 1;
+        if (malformed) break;
+
+        pollfd waitFor = { connection.socket, POLLIN, 0 };
+        int ready = poll(&waitFor, 1, timeoutMs);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) return 0;
+
+        ssize_t received = (ready > 0) ? recv(connection.socket, connection.inbox + connection.inboxSize,
+                                              NET_INBOX_SIZE - connection.inboxSize, 0) : -1;
+        if (received <= 0) break;
+        connection.inboxSize += (int)received;
+        timeoutMs = 0;          // Whatever else is already here, but don't wait again
+    }
+    CloseNetConnection(connection);
+    return -1;
+}
+#else
+// No sockets on this platform; the game keeps using its own database
+bool OpenNetConnection(NetConnection &connection, int port) { connection.socket = -1; return false; }
+void CloseNetConnection(NetConnection &connection) { connection.socket = -1; }
+bool SendNetScores(NetConnection &connection, const NetScore *scores, int count) { return false; }
+bool SendNetSubscribe(NetConnection &connection) { return false; }
+int ReceiveNetMessage(NetConnection &connection, NetMessage &message, int timeoutMs) { return -1; }
+#endif
@@ -0,0 +1,88 @@
+#ifndef LEADERBOARD_NET_H
+#define LEADERBOARD_NET_H
+
+#include "leaderboard.h"
+#include <cstdint>
+
+//----------------------------------------------------------------------------------
+// Leaderboard server protocol
+//----------------------------------------------------------------------------------
+// Several game instances on one machine share a leaderboard through
+// tools/leaderboard_server, which owns the database. Connections are TCP on
+// 127.0.0.1 only; messages are a fixed header followed by count fixed-size
+// records, in host byte order (both ends are on the same machine).
+//
+//   client -> server  NET_MSG_SUBMIT     count NetScore, any number in flight
+//   client -> server  NET_MSG_SUBSCRIBE  no records
+//   server -> client  NET_MSG_ACK        count = scores from this connection now committed, in order
+//   server -> client  NET_MSG_TABLE      one NetTable, on subscribe and whenever a mode's top N changes
+//
+// The server commits everything that arrived since its last commit in one
+// transaction. Scores are best-per-name, so resending unacknowledged ones after
+// a reconnect is harmless.
+// No raylib dependency; not available on PLATFORM_WEB or Windows.
+
+#define LEADERBOARD_PORT_DEFAULT 47800
+#define NET_SUBMIT_MAX 256                  // Scores per NET_MSG_SUBMIT
+
+typedef enum NetMessageType {
+    NET_MSG_SUBMIT = 1,
+    NET_MSG_SUBSCRIBE,
+    NET_MSG_ACK,
+    NET_MSG_TABLE,
+} NetMessageType;
+
+struct NetHeader {
+    uint32_t type;
+    uint32_t count;
+};
+
+struct NetScore {
+    char name[32];
+    int32_t score;
+    float time;
+    int32_t mode;
+};
+
+struct NetTable {
+    int32_t mode;
+    int32_t count;
+    NetScore entries[LEADERBOARD_TOP_N];
+};
+
+// Length of the complete message at the start of data, 0 if more bytes are needed, -1 if malformed
+int GetNetMessageSize(const char *data, int size);
+
+NetScore MakeNetScore(const char *name, int score, float time, GameMode mode);
+NetTable MakeNetTable(const LeaderboardTable &table);
+bool ReadNetTable(const NetTable &net, LeaderboardTable &table);      // False if the mode or count is out of range
+
+//----------------------------------------------------------------------------------
+// Client connection (blocking sends, buffered receives)
+//----------------------------------------------------------------------------------
+#define NET_INBOX_SIZE 4096
+
+struct NetConnection {
+    int socket;                             // -1 when closed
+    int inboxSize;
+    char inbox[NET_INBOX_SIZE];
+};
+
+// One received message; table is only filled for NET_MSG_TABLE
+struct NetMessage {
+    NetMessageType type;
+    int count;
+    NetTable table;
+};
+
+bool OpenNetConnection(NetConnection &connection, int port);     // Connect to the server on localhost
+void CloseNetConnection(NetConnection &connection);
+
+bool SendNetScores(NetConnection &connection, const NetScore *scores, int count);
+bool SendNetSubscribe(NetConnection &connection);
+
+// Next message from the server, waiting up to timeoutMs for one (0: don't wait).
+// 1 if message was filled, 0 if nothing arrived, -1 if the connection was lost (it is closed).
+int ReceiveNetMessage(NetConnection &connection, NetMessage &message, int timeoutMs);
+
+#endif // LEADERBOARD_NET_H
@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------------
+// SQLite leaderboard storage, one row per (name, mode). Desktop builds and tools.
+//----------------------------------------------------------------------------------
+#include "leaderboard.h"
+#include <sqlite3.h>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+// SQLite database pointer
+static sqlite3 *db = nullptr;
+
+// Statements prepared once when the storage is opened and reused with bind/reset
+static sqlite3_stmt *upsertStmt = nullptr;
+static sqlite3_stmt *topStmt = nullptr;
+
+// The persistence worker and the render thread share the statements above
+static std::mutex statementMutex;
+
+// Keep one row per (name, mode) and insert-or-improve it in a single statement
+static const char *UPSERT_SQL =
+    "INSERT INTO leaderboard (name, score, time, mode) VALUES (?1, ?2, ?3, ?4) "
+    "ON CONFLICT (name, mode) DO UPDATE SET score = excluded.score, time = excluded.time "
+    "WHERE excluded.score > leaderboard.score;";
+
+static const char *TOP_SQL =
+    "SELECT name, score, time FROM leaderboard WHERE mode = ?1 ORDER BY score DESC LIMIT ?2;";
+
+// Schema migrations, applied in order. user_version holds the number already applied,
+// so append new steps here and never edit old ones.
+static const char *MIGRATIONS[] = {
+    // 1: original table
+    "CREATE TABLE IF NOT EXISTS leaderboard (id INTEGER PRIMARY KEY, name TEXT, score INT, time FLOAT, mode TEXT);",
+
+    // 2: one row per (name, mode); keep the best row if older builds left duplicates
+    "DELETE FROM leaderboard WHERE EXISTS (SELECT 1 FROM leaderboard b WHERE b.name = leaderboard.name AND b.mode = leaderboard.mode "
+    "AND (b.score > leaderboard.score OR (b.score = leaderboard.score AND b.id < leaderboard.id)));"
+    "CREATE UNIQUE INDEX IF NOT EXISTS leaderboard_name_mode ON leaderboard (name, mode);",
+
+    // 3: covering index so top-N per mode is an index range scan with no table lookups
+    "CREATE INDEX IF NOT EXISTS leaderboard_mode_score ON leaderboard (mode, score DESC, name, time);",
+};
+static const int MIGRATION_COUNT = sizeof(MIGRATIONS) / sizeof(MIGRATIONS[0]);
+
+// Bring the schema up to date, each step in its own transaction
+static bool MigrateDatabase(void) {
+    int version = 0;
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) != SQLITE_OK) return false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) version = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+
+    for (int i = version; i < MIGRATION_COUNT; i++) {
+        std::string sql = std::string("BEGIN;") + MIGRATIONS[i] + "PRAGMA user_version = " + std::to_string(i + 1) + ";COMMIT;";
+        if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Open, create and migrate the database
+static bool OpenSqliteStorage(const char *path) {
+    if (sqlite3_open(path, &db)) {
+        return false;
+    }
+#if !defined(PLATFORM_WEB)
+    // WAL keeps readers off the writer's lock and only fsyncs at checkpoints.
+    // MEMFS on the web has no shared memory for the WAL index, keep the default journal there.
+    sqlite3_exec(db, "PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL;", nullptr, nullptr, nullptr);
+#endif
+    if (!MigrateDatabase()) return false;
+
+    if (sqlite3_prepare_v2(db, UPSERT_SQL, -1, &upsertStmt, nullptr) != SQLITE_OK) return false;
+    if (sqlite3_prepare_v2(db, TOP_SQL, -1, &topStmt, nullptr) != SQLITE_OK) return false;
+    return true;
+}
+
+static const char *GetSqliteError(void) {
+    return db ? sqlite3_errmsg(db) : "database not opened";
+}
+
+static void CloseSqliteStorage(void) {
+    sqlite3_finalize(upsertStmt);   // finalize(nullptr) is a no-op
+    sqlite3_finalize(topStmt);
+    upsertStmt = topStmt = nullptr;
+    sqlite3_close(db);
+    db = nullptr;
+}
+
+// Insert or update scores in the database
+static ScoreInsertResult InsertSqliteScore(const char *name, int score, float time, GameMode mode) {
+    std::lock_guard<std::mutex> lock(statementMutex);
+    if (upsertStmt == nullptr) return SCORE_INSERT_FAILED;
+
+    sqlite3_bind_text(upsertStmt, 1, name, -1, SQLITE_STATIC);
+    sqlite3_bind_int(upsertStmt, 2, score);
+    sqlite3_bind_double(upsertStmt, 3, time);
+    sqlite3_bind_text(upsertStmt, 4, GetGameModeString(mode), -1, SQLITE_STATIC);
+
+    ScoreInsertResult result = SCORE_INSERT_FAILED;
+    if (sqlite3_step(upsertStmt) == SQLITE_DONE) result = (sqlite3_changes(db) > 0) ? SCORE_NEW_BEST : SCORE_NOT_IMPROVED;
+    sqlite3_reset(upsertStmt);
+    sqlite3_clear_bindings(upsertStmt);
+    return result;
+}
+
+// Group several InsertScore calls into one transaction (one sync instead of one per score)
+static bool BeginSqliteBatch(void) {
+    std::lock_guard<std::mutex> lock(statementMutex);
+    return sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+static bool CommitSqliteBatch(void) {
+    std::lock_guard<std::mutex> lock(statementMutex);
+    return sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+// A failed COMMIT (SQLITE_BUSY, disk full) leaves the transaction open
+static void RollbackSqliteBatch(void) {
+    std::lock_guard<std::mutex> lock(statementMutex);
+    sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+}
+
+// Load leaderboard from the database based on mode
+static void LoadSqliteLeaderboard(GameMode mode, LeaderboardTable &table) {
+    table.mode = mode;
+    table.count = 0;
+    std::lock_guard<std::mutex> lock(statementMutex);
+    if (topStmt == nullptr) return;
+
+    sqlite3_bind_text(topStmt, 1, GetGameModeString(mode), -1, SQLITE_STATIC);
+    sqlite3_bind_int(topStmt, 2, LEADERBOARD_TOP_N);
+    while (table.count < LEADERBOARD_TOP_N && sqlite3_step(topStmt) == SQLITE_ROW) {
+        LeaderboardEntry &entry = table.entries[table.count++];
+        strncpy(entry.name, reinterpret_cast<const char *>(sqlite3_column_text(topStmt, 0)), sizeof(entry.name) - 1);
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        entry.score = sqlite3_column_int(topStmt, 1);
+        entry.time = static_cast<float>(sqlite3_column_double(topStmt, 2));
+        entry.mode = mode;
+    }
+    sqlite3_reset(topStmt);
+    sqlite3_clear_bindings(topStmt);
+}
+
+const LeaderboardStorage SQLITE_STORAGE = {
+    "sqlite",
+    OpenSqliteStorage,
+    CloseSqliteStorage,
+    GetSqliteError,
+    InsertSqliteScore,
+    BeginSqliteBatch,
+    CommitSqliteBatch,
+    RollbackSqliteBatch,
+    LoadSqliteLeaderboard,
+};
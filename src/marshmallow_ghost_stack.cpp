@@ -1,12 +1,21 @@
 #include "raylib.h"
-#include <sqlite3.h>
+#include "asset_loader.h"
+#include "audio_mixer.h"
+#include "assets.h"
+#include "atlas.h"
+#include "game_state.h"
+#include "input_log.h"
+#include "leaderboard.h"
+#include "parallax.h"
+#include "persistence.h"
+#include "profiler.h"
+#include "text.h"
+#include "ui_cache.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <string>
-#include <vector>
-#include <sstream>
 
-// Define game screens and modes
-typedef enum GameScreen { LOGO = 0, TITLE, INSTRUCTIONS, MODE_SELECT, NAME_INPUT, GAMEPLAY, ENDING, LEADERBOARD_SELECTION } GameScreen;
-typedef enum GameMode { EASY = 0, NORMAL, HARD, TIMED } GameMode;
 //#define PLATFORM_WEB
 
 #if defined(PLATFORM_WEB)
@@ -22,210 +31,276 @@ const int screenWidth = 800;
 const int screenHeight = 600;
 
 Music backgroundMusic;
-Texture2D background, platformTexture, bonfireTexture;
+TextureAtlas atlas;     // Background, bonfire, platform and marshmallow sprites
 Sound clickSound, burnSound;
 float deltaTime = 0.0f;
-float roastingSpeed = 1.0f;
-float timeRemaining = 30.0f;
-int winScore = 50;
-int score = 0;
-int letterCount = 0;
-bool displayLeaderboard = false;
-char playerName[32] = "";
-GameScreen currentScreen = TITLE;
-GameMode currentMode = EASY;
-
-// Declare the marshmallow texture array globally
-Texture2D marshmallowTextures[4];
-
-// Define the marshmallow structure
-struct Marshmallow {
-    Vector2 position;
-    int state; // 0: white, 1: yellow, 2: brown, 3: black
-    float roastTimer;
-    Texture2D texture;
-    Rectangle bounds;
-};
-
-// Declare marshmallows array globally so it can be used across all functions
-Marshmallow marshmallows[4];
-
-// Leaderboard structure
-struct LeaderboardEntry {
-    std::string name;
-    int score;
-    float time;
-    std::string mode;
-};
-
-// SQLite database pointer
-sqlite3 *db;
-std::vector<LeaderboardEntry> leaderboard;
-GameMode currentLeaderboardMode = EASY; // Track the current mode displayed on the leaderboard
+int targetFPS = 60;     // --fps <n>, 0 for uncapped; the simulation rate doesn't depend on it
+#if defined(PLATFORM_WEB)
+std::string leaderboardPath = "/persist/leaderboard" LEADERBOARD_JOURNAL_EXT;   // IDBFS, loaded by shell.html before main()
+#else
+std::string leaderboardPath = BASE_PATH + "leaderboard.db";    // --storage journal for BASE_PATH + "leaderboard.journal"
+#endif
+int leaderboardPort = 0;    // --leaderboard-port <n>, share scores through tools/leaderboard_server instead of the local database
+
+// Simulation state, advanced by GameStep() once per frame
+GameState game;
+
+// --record <file> writes every frame's input, --replay <file> plays one back instead of live input
+InputLog inputRecording = {};
+InputLog inputReplay = {};
+
+// Resident top-N per mode, loaded once at startup and updated in place when a game ends
+LeaderboardTable leaderboardCache[GAME_MODE_COUNT];
+const LeaderboardTable *leaderboard = &leaderboardCache[EASY]; // Table currently on screen
+
+bool showProfiler = false;  // F3 toggles the frame time overlay
+
+// Menu screens are drawn into this once per change instead of every frame
+UiCache menuCache;
+unsigned int leaderboardVersion = 0;    // Bumped whenever a resident leaderboard table changes
+
+// UI text is in the arcadian font once the loader has it, raylib's built-in one until then
+TextFont uiFont;
+TextFont defaultFont;       // Also the profiler overlay's
+TextLayout scoreLayout, timeLayout;     // HUD, rebuilt only when the value shown changes
+TextBuffer textBuffer;      // Scratch for strings with numbers in them
+
+const TextFont &GetUiFont() {
+    return (uiFont.texture.id != 0) ? uiFont : defaultFont;
+}
 
 //----------------------------------------------------------------------------------
 // Module functions declaration
 //----------------------------------------------------------------------------------
-// Function to reset marshmallow state
-void ResetMarshmallow(Marshmallow &m, Texture2D textures[]) {
-    m.state = 0;
-    m.roastTimer = 0;
-    m.texture = textures[0]; // Start with white marshmallow
-}
-
-// Function to update the marshmallow roasting state
-void UpdateMarshmallow(Marshmallow &m, float deltaTime, Texture2D textures[], float roastSpeed) {
-    m.roastTimer += deltaTime * roastSpeed;
-    if (m.roastTimer > 6.0f) {
-        m.state = 3; // Burnt
-        m.texture = textures[3];
-    } else if (m.roastTimer > 4.0f) {
-        m.state = 2; // Brown
-        m.texture = textures[2];
-    } else if (m.roastTimer > 2.0f) {
-        m.state = 1; // Yellow
-        m.texture = textures[1];
+// Display leaderboard
+void DisplayLeaderboard() {
+    const TextFont &font = GetUiFont();
+    if (leaderboard->count == 0) {
+        DrawTextQuick(font, "No leaderboard data yet.", screenWidth / 2 - 150, 200, 30, WHITE);
+    } else {
+        DrawTextQuick(font, "Leaderboard", screenWidth / 2 - 100, 100, 30, WHITE);
+        ClearText(textBuffer);
+        AppendText(textBuffer, "Current Mode: ");
+        AppendText(textBuffer, GetGameModeString(game.leaderboardMode));
+        DrawTextQuick(font, textBuffer.text, screenWidth / 2 - 150, 140, 20, WHITE);
+        for (int i = 0; i < leaderboard->count; i++) {
+            const LeaderboardEntry &entry = leaderboard->entries[i];
+            ClearText(textBuffer);
+            AppendInt(textBuffer, i + 1);
+            AppendText(textBuffer, ". ");
+            AppendText(textBuffer, entry.name);
+            AppendText(textBuffer, " - Score: ");
+            AppendInt(textBuffer, entry.score);
+            AppendText(textBuffer, ", Time: ");
+            AppendFloat(textBuffer, entry.time, 1);
+            AppendText(textBuffer, " sec");
+            DrawTextQuick(font, textBuffer.text, screenWidth / 2 - 200, 180 + (int)i * 30, 20, WHITE);
+        }
     }
 }
 
-// Check if the marshmallow was clicked
-bool IsMarshmallowClicked(Marshmallow m, Vector2 mousePos) {
-    return CheckCollisionPointRec(mousePos, m.bounds);
-}
+// Background scrolling layers, filled in by the asset loader
+ParallaxBackground parallax;
+ParallaxSet parallaxSet = GetDefaultParallaxSet();
+
+// Function to draw the SWARM platforms and the marshmallows currently on screen
+void DrawSwarm(float alpha) {
+    static int visible[MARSHMALLOW_POOL_MAX];
+    const MarshmallowPool &pool = game.marshmallows;
+    float scroll = game.previousPlatformScroll + (game.platformScroll - game.previousPlatformScroll) * alpha;
+
+    const Rectangle &platform = atlas.sprites[SPRITE_PLATFORM];
+    float tileX = -fmodf(scroll, platform.width);
+    for (int row = 0; row < game.rules.swarmRows; row++) {
+        for (float x = tileX; x < screenWidth; x += platform.width) {
+            DrawSprite(atlas, SPRITE_PLATFORM, x, SWARM_TOP + row * SWARM_ROW_HEIGHT + 50);
+        }
+    }
 
-// Convert GameMode enum to string
-const char* GetGameModeString(GameMode mode) {
-    switch (mode) {
-        case EASY: return "EASY";
-        case NORMAL: return "NORMAL";
-        case HARD: return "HARD";
-        case TIMED: return "TIMED";
-        default: return "UNKNOWN";
+    int count = QueryMarshmallows(pool, scroll, scroll + screenWidth, visible, MARSHMALLOW_POOL_MAX);
+    for (int k = 0; k < count; k++) {
+        int i = visible[k];
+        DrawSprite(atlas, (AtlasSprite)(SPRITE_MARSHMALLOW_WHITE + pool.state[i]), GetMarshmallowViewX(pool, i, scroll), pool.y[i]);
     }
 }
 
-// Initialize the database
-void InitDatabase() {
-    if (sqlite3_open((BASE_PATH + "leaderboard.db").c_str(), &db)) {
-        TraceLog(LOG_ERROR, "Can't open database: %s", sqlite3_errmsg(db));
-    } else {
-        const char *sql = "CREATE TABLE IF NOT EXISTS leaderboard (id INTEGER PRIMARY KEY, name TEXT, score INT, time FLOAT, mode TEXT);";
-        sqlite3_exec(db, sql, nullptr, nullptr, nullptr);
-    }
+// Sample this frame's raylib input for the simulation
+GameInput ReadGameInput() {
+    GameInput input = {};
+    if (IsKeyPressed(KEY_ENTER)) input.keys |= GAME_KEY_ENTER;
+    if (IsKeyPressed(KEY_BACKSPACE)) input.keys |= GAME_KEY_BACKSPACE;
+    if (IsKeyPressed(KEY_L)) input.keys |= GAME_KEY_L;
+    if (IsKeyPressed(KEY_ONE)) input.keys |= GAME_KEY_ONE;
+    if (IsKeyPressed(KEY_TWO)) input.keys |= GAME_KEY_TWO;
+    if (IsKeyPressed(KEY_THREE)) input.keys |= GAME_KEY_THREE;
+    if (IsKeyPressed(KEY_FOUR)) input.keys |= GAME_KEY_FOUR;
+    if (IsKeyPressed(KEY_FIVE)) input.keys |= GAME_KEY_FIVE;
+    input.keyPressed = GetKeyPressed();
+    input.mousePressed = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    Vector2 mousePos = GetMousePosition();
+    input.mouseX = mousePos.x;
+    input.mouseY = mousePos.y;
+    return input;
 }
 
-// Insert or update scores in the database
-void InsertScore(const char *name, int score, float time, const char *mode) {
-    std::stringstream checkQuery;
-    checkQuery << "SELECT score FROM leaderboard WHERE name = '" << name << "' AND mode = '" << mode << "';";
-    
-    sqlite3_stmt *stmt;
-    int existingScore = -1;
-
-    if (sqlite3_prepare_v2(db, checkQuery.str().c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            existingScore = sqlite3_column_int(stmt, 0);
+// Play sounds and save scores for what the simulation did this frame
+void HandleGameEvents() {
+    if (game.events & GAME_EVENT_CLICK) PlaySfx(SFX_CLICK);
+    if (game.events & GAME_EVENT_BURN) PlaySfx(SFX_BURN);
+
+    if (game.events & GAME_EVENT_GAME_OVER) {
+        // Record the finished game exactly once: update the resident table now,
+        // the worker writes it to disk and publishes the stored rows back
+        InsertLeaderboardEntry(leaderboardCache[game.mode], game.playerName, game.score, game.timeRemaining);
+        leaderboardVersion++;
+        if (!PersistenceSubmitScore(game.playerName, game.score, game.timeRemaining, game.mode)) {
+            TraceLog(LOG_WARNING, "Score queue full, score for %s not saved", game.playerName);
         }
     }
-    sqlite3_finalize(stmt);
-
-    if (existingScore == -1) {
-        std::stringstream insertQuery;
-        insertQuery << "INSERT INTO leaderboard (name, score, time, mode) VALUES ('" 
-                    << name << "', " << score << ", " << time << ", '" << mode << "');";
-        sqlite3_exec(db, insertQuery.str().c_str(), nullptr, nullptr, nullptr);
-    } else if (score > existingScore) {
-        std::stringstream updateQuery;
-        updateQuery << "UPDATE leaderboard SET score = " << score << ", time = " << time
-                    << " WHERE name = '" << name << "' AND mode = '" << mode << "';";
-        sqlite3_exec(db, updateQuery.str().c_str(), nullptr, nullptr, nullptr);
+
+    if (game.events & (GAME_EVENT_GAME_OVER | GAME_EVENT_LEADERBOARD_CHANGED)) {
+        leaderboard = &leaderboardCache[game.leaderboardMode];
     }
 }
 
-// Load leaderboard from the database based on mode
-void LoadLeaderboard(const char *mode) {
-    leaderboard.clear();
-    std::stringstream ss;
-    ss << "SELECT name, score, time FROM leaderboard WHERE mode = '" << mode << "' ORDER BY score DESC LIMIT 5;";
-    sqlite3_stmt *stmt;
-
-    if (sqlite3_prepare_v2(db, ss.str().c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            LeaderboardEntry entry;
-            entry.name = std::string(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
-            entry.score = sqlite3_column_int(stmt, 1);
-            entry.time = static_cast<float>(sqlite3_column_double(stmt, 2));
-            leaderboard.push_back(entry);
-        }
+// Profiler overlay columns: label (cut to 10 characters), p50, p99, max, then samples or units
+const int PROFILER_LABEL_CHARS = 10;
+const int PROFILER_COLUMNS[4] = { 65, 110, 155, 200 };
+
+// Function to draw one overlay row: a label, then p50/p99/max and optionally the sample count
+void DrawProfilerRow(int x, int y, const char *label, const ProfileStats &stats, bool samples) {
+    ClearText(textBuffer);
+    AppendText(textBuffer, label);
+    if (textBuffer.length > PROFILER_LABEL_CHARS) textBuffer.text[textBuffer.length = PROFILER_LABEL_CHARS] = '\0';
+    DrawTextQuick(defaultFont, textBuffer.text, x, y, 10, WHITE);
+    float values[3] = { stats.p50, stats.p99, stats.max };
+    for (int v = 0; v < 3; v++) {
+        ClearText(textBuffer);
+        AppendFloat(textBuffer, values[v], 2);
+        DrawTextQuick(defaultFont, textBuffer.text, x + PROFILER_COLUMNS[v], y, 10, WHITE);
+    }
+    if (samples) {
+        ClearText(textBuffer);
+        AppendInt(textBuffer, stats.samples);
+        DrawTextQuick(defaultFont, textBuffer.text, x + PROFILER_COLUMNS[3], y, 10, WHITE);
     }
-    sqlite3_finalize(stmt);
 }
 
-// Display leaderboard
-void DisplayLeaderboard() {
-    if (leaderboard.empty()) {
-        DrawText("No leaderboard data yet.", screenWidth / 2 - 150, 200, 30, WHITE);
-    } else {
-        DrawText("Leaderboard", screenWidth / 2 - 100, 100, 30, WHITE);
-        DrawText(TextFormat("Current Mode: %s", GetGameModeString(currentLeaderboardMode)), screenWidth / 2 - 150, 140, 20, WHITE);
-        for (size_t i = 0; i < leaderboard.size(); i++) {
-            DrawText(TextFormat("%d. %s - Score: %d, Time: %.1f sec", i + 1, leaderboard[i].name.c_str(), leaderboard[i].score, leaderboard[i].time),
-                     screenWidth / 2 - 200, 180 + (int)i * 30, 20, WHITE);
-        }
+// Function to draw p50/p99/max per phase, and frame time per screen, over the last few seconds
+void DrawProfilerOverlay() {
+    const int x = 10, lineHeight = 12;
+    int screensSeen = 0;
+    for (int s = 0; s < GAME_SCREEN_COUNT; s++) {
+        if (GetProfileScreenStats(PROFILE_FRAME, (GameScreen)s).samples > 0) screensSeen++;
+    }
+    int y = screenHeight - 10 - (PROFILE_PHASE_COUNT + screensSeen + 3) * lineHeight;
+
+    DrawRectangle(x - 5, y - 5, 330, (PROFILE_PHASE_COUNT + screensSeen + 3) * lineHeight + 10, Fade(BLACK, 0.7f));
+    const char *columns[3] = { "p50", "p99", "max" };
+    DrawTextQuick(defaultFont, "phase", x, y, 10, YELLOW);
+    for (int c = 0; c < 3; c++) DrawTextQuick(defaultFont, columns[c], x + PROFILER_COLUMNS[c], y, 10, YELLOW);
+    ClearText(textBuffer);
+    AppendText(textBuffer, "(ms, last ");
+    AppendInt(textBuffer, PROFILE_STATS_FRAMES);
+    AppendText(textBuffer, " frames)");
+    DrawTextQuick(defaultFont, textBuffer.text, x + PROFILER_COLUMNS[3], y, 10, YELLOW);
+    y += lineHeight;
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        DrawProfilerRow(x, y, GetProfilePhaseString((ProfilePhase)p), GetProfileStats((ProfilePhase)p), false);
+        y += lineHeight;
+    }
+    y += lineHeight;
+    DrawTextQuick(defaultFont, "frame time by screen", x, y, 10, YELLOW);
+    y += lineHeight;
+    for (int s = 0; s < GAME_SCREEN_COUNT; s++) {
+        ProfileStats stats = GetProfileScreenStats(PROFILE_FRAME, (GameScreen)s);
+        if (stats.samples == 0) continue;
+        DrawProfilerRow(x, y, GetGameScreenString((GameScreen)s), stats, true);
+        y += lineHeight;
     }
 }
 
-// Function to load and resize a texture to specified dimensions
-Texture2D LoadTextureAndResize(const char* fileName, int width, int height) {
-    Image img = LoadImage(fileName);  // Load the image file
-    ImageResize(&img, width, height); // Resize the image to the desired dimensions
-    Texture2D texture = LoadTextureFromImage(img); // Convert Image to Texture
-    UnloadImage(img);  // Unload image from memory after conversion
-    return texture;
-}
+// Function to draw the static content of the menu screens, into the UI cache
+void DrawMenuScreen() {
+    const TextFont &font = GetUiFont();
+    switch (game.screen) {
+        case TITLE:
+            if (atlas.texture.id != 0) DrawSprite(atlas, SPRITE_BACKGROUND, 0, 0);    // Baked in, so the title is one quad too
+            DrawTextQuick(font, "Marshmallow Roasting Game", screenWidth / 2 - 200, screenHeight / 2 - 20, 40, WHITE);
+            DrawTextQuick(font, "Press Enter to Continue", screenWidth / 2 - 150, screenHeight / 2 + 40, 20, WHITE);
+            DrawTextQuick(font, "Press 'L' to View Leaderboard", screenWidth / 2 - 150, screenHeight / 2 + 80, 20, WHITE);
+            if (game.displayLeaderboard) {
+                DisplayLeaderboard();
+            }
+            break;
+
+        case INSTRUCTIONS:
+            DrawTextQuick(font, "Instructions: Roast marshmallows to score points.", screenWidth / 2 - 200, screenHeight / 2 - 50, 20, WHITE);
+            DrawTextQuick(font, "Press Enter to return to the Title screen.", screenWidth / 2 - 200, screenHeight / 2, 20, WHITE);
+            break;
 
-// Background scrolling variables for parallax effect
-struct ParallaxLayer {
-    Texture2D texture;
-    float scrollingOffset;
-    float speed;
-};
-
-ParallaxLayer parallaxLayers[5];
-
-// Function to update a specific parallax layer if it has a non-zero speed
-void UpdateParallaxLayer(ParallaxLayer &layer, float deltaTime) {
-    if (layer.speed != 0.0f) {
-        layer.scrollingOffset -= layer.speed * deltaTime;
-        if (layer.scrollingOffset <= -layer.texture.width) {
-            layer.scrollingOffset = 0;
+        case NAME_INPUT: {
+            DrawTextQuick(font, "Enter your name:", screenWidth / 2 - 150, screenHeight / 2 - 50, 20, DARKGRAY);
+            DrawTextQuick(font, game.playerName, screenWidth / 2 - 150, screenHeight / 2, 30, WHITE);
+            break;
         }
-    }
-}
 
-// Function to initialize parallax layers
-void InitializeParallaxLayers() {
-    parallaxLayers[0] = { LoadTextureAndResize((BASE_PATH + "resources/textures/parallax/background 2/Plan-5.png").c_str(), screenWidth, screenHeight), 0.0f, 50.0f }; // Static background
-    parallaxLayers[1] = { LoadTextureAndResize((BASE_PATH + "resources/textures/parallax/background 2/Plan-4.png").c_str(), screenWidth, screenHeight), 0.0f, 1.0f }; // Slow moving clouds
-    parallaxLayers[2] = { LoadTextureAndResize((BASE_PATH + "resources/textures/parallax/background 2/Plan-3.png").c_str(), screenWidth, screenHeight), 0.0f, 0.0f }; // Static mountains
-    parallaxLayers[3] = { LoadTextureAndResize((BASE_PATH + "resources/textures/parallax/background 2/Plan-2.png").c_str(), screenWidth, screenHeight), 0.0f, 0.0f }; // Moving trees
-    parallaxLayers[4] = { LoadTextureAndResize((BASE_PATH + "resources/textures/parallax/background 2/Plan-1.png").c_str(), screenWidth, screenHeight), 0.0f, 25.0f }; // Fast moving foreground
-}
+        case LEADERBOARD_SELECTION:
+            DrawTextQuick(font, "Select Leaderboard Mode", screenWidth / 2 - 150, screenHeight / 2 - 100, 30, WHITE);
+            DrawTextQuick(font, "1. Easy", screenWidth / 2 - 100, screenHeight / 2 - 60, 20, WHITE);
+            DrawTextQuick(font, "2. Normal", screenWidth / 2 - 100, screenHeight / 2 - 20, 20, WHITE);
+            DrawTextQuick(font, "3. Hard", screenWidth / 2 - 100, screenHeight / 2 + 20, 20, WHITE);
+            DrawTextQuick(font, "4. Timed", screenWidth / 2 - 100, screenHeight / 2 + 60, 20, WHITE);
+            DrawTextQuick(font, "5. Swarm", screenWidth / 2 - 100, screenHeight / 2 + 100, 20, WHITE);
+            break;
+
+        case MODE_SELECT:
+            DrawTextQuick(font, "Select Game Mode", screenWidth / 2 - 100, screenHeight / 2 - 100, 30, WHITE);
+            DrawTextQuick(font, "1. Easy", screenWidth / 2 - 100, screenHeight / 2 - 60, 20, WHITE);
+            DrawTextQuick(font, "2. Normal", screenWidth / 2 - 100, screenHeight / 2 - 20, 20, WHITE);
+            DrawTextQuick(font, "3. Hard", screenWidth / 2 - 100, screenHeight / 2 + 20, 20, WHITE);
+            DrawTextQuick(font, "4. Timed", screenWidth / 2 - 100, screenHeight / 2 + 60, 20, WHITE);
+            DrawTextQuick(font, "5. Swarm", screenWidth / 2 - 100, screenHeight / 2 + 100, 20, WHITE);
+            if (!IsAssetGroupLoaded(ASSET_GROUP_GAMEPLAY)) {
+                ClearText(textBuffer);
+                AppendText(textBuffer, "Loading... ");
+                AppendInt(textBuffer, (int)(GetAssetGroupProgress(ASSET_GROUP_GAMEPLAY) * 100));
+                AppendText(textBuffer, "%");
+                DrawTextQuick(font, textBuffer.text, screenWidth / 2 - 100, screenHeight / 2 + 150, 20, WHITE);
+            }
+            break;
+
+        case ENDING:
+            DrawTextQuick(font, "Congratulations!", screenWidth / 2 - 200, screenHeight / 2 - 20, 40, WHITE);
+            ClearText(textBuffer);
+            AppendText(textBuffer, "Your Score: ");
+            AppendInt(textBuffer, game.score);
+            DrawTextQuick(font, textBuffer.text, screenWidth / 2 - 100, screenHeight / 2 + 20, 30, WHITE);
+            DrawTextQuick(font, "Press Enter to return to Title Screen", screenWidth / 2 - 250, screenHeight / 2 + 60, 20, WHITE);
+
+            DisplayLeaderboard();  // Show leaderboard on ending screen
+            break;
 
-// Function to draw the parallax layers
-void DrawParallaxLayers() {
-    for (int i = 0; i < 5; i++) {
-        DrawTextureEx(parallaxLayers[i].texture, (Vector2){ parallaxLayers[i].scrollingOffset, 0 }, 0.0f, 1.0f, WHITE);
-        DrawTextureEx(parallaxLayers[i].texture, (Vector2){ parallaxLayers[i].scrollingOffset + parallaxLayers[i].texture.width, 0 }, 0.0f, 1.0f, WHITE);
+        default: break;
     }
 }
-// Function to reset the game
-void ResetGame() {
-    score = 0;
-    timeRemaining = 30.0f;
-    for (int i = 0; i < 4; i++) {
-        ResetMarshmallow(marshmallows[i], marshmallowTextures);
-    }
+
+// Everything DrawMenuScreen() reads; the cached layer is redrawn when this changes
+unsigned int GetMenuCacheKey() {
+    unsigned int key = UI_KEY_SEED;
+    int loading = IsAssetGroupLoaded(ASSET_GROUP_GAMEPLAY) ? 100 : (int)(GetAssetGroupProgress(ASSET_GROUP_GAMEPLAY) * 100);
+    bool background = atlas.texture.id != 0;
+    bool customFont = uiFont.texture.id != 0;
+    key = HashUiKey(key, &game.screen, sizeof(game.screen));
+    key = HashUiKey(key, &game.displayLeaderboard, sizeof(game.displayLeaderboard));
+    key = HashUiKey(key, &game.leaderboardMode, sizeof(game.leaderboardMode));
+    key = HashUiKey(key, &game.score, sizeof(game.score));
+    key = HashUiKey(key, game.playerName, game.letterCount + 1);
+    key = HashUiKey(key, &leaderboardVersion, sizeof(leaderboardVersion));
+    key = HashUiKey(key, &loading, sizeof(loading));
+    key = HashUiKey(key, &background, sizeof(background));
+    key = HashUiKey(key, &customFont, sizeof(customFont));
+    return key;
 }
 
 void UpdateDrawFrame(void);     // Update and Draw one frame
@@ -234,45 +309,68 @@ void UpdateDrawFrame(void);     // Update and Draw one frame
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char **argv)
 {
+    // Command line
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "--record") == 0 && !OpenInputRecording(inputRecording, argv[i + 1])) {
+            TraceLog(LOG_WARNING, "Can't record input to %s", argv[i + 1]);
+        } else if (strcmp(argv[i], "--replay") == 0 && !OpenInputReplay(inputReplay, argv[i + 1])) {
+            TraceLog(LOG_WARNING, "Can't replay input from %s", argv[i + 1]);
+        } else if (strcmp(argv[i], "--fps") == 0) {
+            targetFPS = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--storage") == 0) {
+            leaderboardPath = BASE_PATH + ((strcmp(argv[i + 1], "journal") == 0) ? "leaderboard" LEADERBOARD_JOURNAL_EXT : "leaderboard.db");
+        } else if (strcmp(argv[i], "--leaderboard-port") == 0) {
+            leaderboardPort = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--trace") == 0 && !OpenProfileTrace(argv[i + 1])) {
+            TraceLog(LOG_WARNING, "Can't write frame trace to %s", argv[i + 1]);
+        } else if (strcmp(argv[i], "--parallax") == 0 && !ScanParallaxSet(BASE_PATH.c_str(), argv[i + 1], parallaxSet)) {
+            TraceLog(LOG_WARNING, "No parallax layers in %s%s", PARALLAX_DIR, argv[i + 1]);
+        }
+    }
+
     // Initialization
     InitWindow(screenWidth, screenHeight, "Marshmallow Roasting Game with Parallax Background");
     InitAudioDevice();
-    SetTargetFPS(60);
-    InitDatabase();
-    LoadLeaderboard("EASY");  // Load leaderboard for default game mode (EASY)
+    InitAudioMixer();
+    if (leaderboardPort > 0 && PersistenceConnect(leaderboardPort, leaderboardPath.c_str())) {
+        // The server pushes every mode's table on connect, they arrive as snapshots
+        for (int m = 0; m < GAME_MODE_COUNT; m++) leaderboardCache[m].mode = (GameMode)m;
+    } else {
+        if (leaderboardPort > 0) TraceLog(LOG_WARNING, "No leaderboard server on port %d, using the local database", leaderboardPort);
+        SetLeaderboardStorage(GetLeaderboardStorageFor(leaderboardPath.c_str()));
+        if (!InitDatabase(leaderboardPath.c_str())) {
+            TraceLog(LOG_ERROR, "Can't open database: %s", GetDatabaseError());
+        }
+        for (int m = 0; m < GAME_MODE_COUNT; m++) {
+            LoadLeaderboard((GameMode)m, leaderboardCache[m]);  // Every tab is resident from here on
+        }
+    }
+    PersistenceStart();  // Scores are written by a background thread from here on
 
     // Load and resize assets
-    background = LoadTextureAndResize((BASE_PATH + "resources/textures/background.png").c_str(), screenWidth, screenHeight);
-    marshmallowTextures[0] = LoadTextureAndResize((BASE_PATH + "resources/images/marshmallow_white.png").c_str(), 64, 64);
-    marshmallowTextures[1] = LoadTextureAndResize((BASE_PATH + "resources/images/marshmallow_yellow.png").c_str(), 64, 64);
-    marshmallowTextures[2] = LoadTextureAndResize((BASE_PATH + "resources/images/marshmallow_brown.png").c_str(), 64, 64);
-    marshmallowTextures[3] = LoadTextureAndResize((BASE_PATH + "resources/images/marshmallow_black.png").c_str(), 64, 64);
-
-    platformTexture = LoadTextureAndResize((BASE_PATH + "resources/images/wooden_platform.png").c_str(), 600, 32); 
-    bonfireTexture = LoadTextureAndResize((BASE_PATH + "resources/images/bonfire.png").c_str(), 128, 128);
-    
-    // Load sound/music once and unload at the end
-    clickSound = LoadSound((BASE_PATH + "resources/audio/click-sound.mp3").c_str());
-    burnSound = LoadSound((BASE_PATH + "resources/audio/burn-sound.mp3").c_str());
-    backgroundMusic = LoadMusicStream((BASE_PATH + "resources/audio/ritual.ogg").c_str());
-    PlayMusicStream(backgroundMusic);
-
-    // Initialize parallax layers
-    InitializeParallaxLayers();
-
-
-    marshmallows[0] = {{150, 200}, 0, 0.0f, marshmallowTextures[0], {150, 200, 64, 64}};
-    marshmallows[1] = {{600, 200}, 0, 0.0f, marshmallowTextures[0], {600, 200, 64, 64}};
-    marshmallows[2] = {{150, 350}, 0, 0.0f, marshmallowTextures[0], {150, 350, 64, 64}};
-    marshmallows[3] = {{600, 350}, 0, 0.0f, marshmallowTextures[0], {600, 350, 64, 64}};
-
+    // Everything decodes on loader threads (fetched first on the web) while the LOGO screen shows progress
+    parallax.width = screenWidth;
+    parallax.height = screenHeight;
+    QueueParallaxLoad(parallaxSet, &parallax, ASSET_GROUP_TITLE);
+    QueueAtlasLoad(&atlas, ASSET_GROUP_GAMEPLAY);
+    QueueSoundLoad((BASE_PATH + "resources/audio/click-sound.mp3").c_str(), &clickSound, ASSET_GROUP_GAMEPLAY);
+    QueueSoundLoad((BASE_PATH + "resources/audio/burn-sound.mp3").c_str(), &burnSound, ASSET_GROUP_GAMEPLAY);
+    QueueMusicLoad((BASE_PATH + "resources/audio/ritual.ogg").c_str(), &backgroundMusic, ASSET_GROUP_GAMEPLAY);
+    QueueFontLoad((BASE_PATH + "resources/font_arcadian.png").c_str(), &uiFont, ASSET_GROUP_TITLE);
+    StartAssetLoading(BASE_PATH.c_str());
+
+    InitGameState(game, DEFAULT_GAME_RULES);
+    LoadUiCache(menuCache, screenWidth, screenHeight);
+    defaultFont = GetDefaultTextFont();
 
 #if defined(PLATFORM_WEB)
+    // fps 0: the browser calls us from requestAnimationFrame. No SetTargetFPS() here, raylib
+    // would wait inside EndDrawing(), and nothing in a frame may block (the build has no ASYNCIFY)
     emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
-    SetTargetFPS(60);   // Set our game to run at 60 frames-per-second
+    SetTargetFPS(targetFPS);   // Rendering rate only, the simulation always steps at GAME_STEP_HZ
     //--------------------------------------------------------------------------------------
 
     // Main game loop
@@ -282,23 +380,26 @@ int main(void)
     }
 #endif
      // Free resources
-    for (int i = 0; i < 4; i++) {
-        UnloadTexture(marshmallowTextures[i]);
-    }
-    UnloadTexture(platformTexture);
-    UnloadTexture(bonfireTexture);
+    UnloadTextureAtlas(atlas);
+    UnloadUiCache(menuCache);
+    UnloadTextFont(uiFont);     // defaultFont belongs to raylib
 
     // Unload parallax layers
-    for (int i = 0; i < 5; i++) {
-        UnloadTexture(parallaxLayers[i].texture);
-    }
+    UnloadParallax(parallax);
 
     // Unload sounds and music
+    CloseAudioMixer();      // Voices alias the sounds, and the feeder reads the music
     UnloadSound(clickSound);
     UnloadSound(burnSound);
     UnloadMusicStream(backgroundMusic);
+    StopAssetLoading();     // After the music stream, which reads from the loader's copy of the file
 
-    sqlite3_close(db);  // Close database
+    CloseInputLog(inputRecording);
+    CloseInputLog(inputReplay);
+    CloseProfileTrace();    // Writes the --trace CSV
+
+    PersistenceStop();  // Flush queued scores before closing the database (or the server connection)
+    CloseDatabase();
     // De-Initialization
     //--------------------------------------------------------------------------------------
     CloseWindow();        // Close window and OpenGL context
@@ -312,239 +413,136 @@ int main(void)
 //----------------------------------------------------------------------------------
 void UpdateDrawFrame(void)
 {
+    ProfileBeginFrame(game.screen);
+#if defined(PLATFORM_WEB)
+    static bool firstFrame = true;
+    if (firstFrame) {
+        firstFrame = false;
+        EM_ASM({ if (Module.onFirstFrame) Module.onFirstFrame(); });    // Startup time, see tools/web_bench.sh
+    }
+#endif
+
     // Update
     //----------------------------------------------------------------------------------
-    deltaTime = GetFrameTime();
-    UpdateMusicStream(backgroundMusic); // Update the music stream properly
-
-    // Update parallax backgrounds
-    for (int i = 0; i < 5; i++) {
-        UpdateParallaxLayer(parallaxLayers[i], deltaTime);
+    // Input and frame time come from the replay log while it lasts, otherwise from raylib
+    GameInput input;
+    if (inputReplay.file == nullptr || !ReadInputFrame(inputReplay, input, deltaTime)) {
+        if (inputReplay.file != nullptr) {
+            TraceLog(LOG_INFO, "Replay finished after %ld frames", inputReplay.frames);
+            CloseInputLog(inputReplay);
+        }
+        input = ReadGameInput();
+        deltaTime = GetFrameTime();
     }
 
-    switch (currentScreen) {
-            case LOGO:
-                if (IsKeyPressed(KEY_ENTER)) currentScreen = TITLE;
-                break;
-
-            case TITLE:
-                if (IsKeyPressed(KEY_ENTER)) {
-                    currentScreen = NAME_INPUT;
-                }
-                if (IsKeyPressed(KEY_L)) {
-                    currentScreen = LEADERBOARD_SELECTION;  // Go to leaderboard mode selection screen
-                }
-                break;
-
-            case LEADERBOARD_SELECTION:
-                DrawText("Select Leaderboard Mode", screenWidth / 2 - 150, screenHeight / 2 - 100, 30, WHITE);
-                DrawText("1. Easy", screenWidth / 2 - 100, screenHeight / 2 - 60, 20, WHITE);
-                DrawText("2. Normal", screenWidth / 2 - 100, screenHeight / 2 - 20, 20, WHITE);
-                DrawText("3. Hard", screenWidth / 2 - 100, screenHeight / 2 + 20, 20, WHITE);
-                DrawText("4. Timed", screenWidth / 2 - 100, screenHeight / 2 + 60, 20, WHITE);
-
-                if (IsKeyPressed(KEY_ONE)) {
-                    currentLeaderboardMode = EASY;
-                    LoadLeaderboard(GetGameModeString(currentLeaderboardMode));
-                    displayLeaderboard = true;  // Set the leaderboard to display
-                    currentScreen = TITLE;  // Return to title after selecting
-                } else if (IsKeyPressed(KEY_TWO)) {
-                    currentLeaderboardMode = NORMAL;
-                    LoadLeaderboard(GetGameModeString(currentLeaderboardMode));
-                    displayLeaderboard = true;  // Set the leaderboard to display
-                    currentScreen = TITLE;
-                } else if (IsKeyPressed(KEY_THREE)) {
-                    currentLeaderboardMode = HARD;
-                    LoadLeaderboard(GetGameModeString(currentLeaderboardMode));
-                    displayLeaderboard = true;  // Set the leaderboard to display
-                    currentScreen = TITLE;
-                } else if (IsKeyPressed(KEY_FOUR)) {
-                    currentLeaderboardMode = TIMED;
-                    LoadLeaderboard(GetGameModeString(currentLeaderboardMode));
-                    displayLeaderboard = true;  // Set the leaderboard to display
-                    currentScreen = TITLE;
-                }
-                break;
-
-            case MODE_SELECT:
-                DrawText("Select Game Mode", screenWidth / 2 - 100, screenHeight / 2 - 100, 30, WHITE);
-                DrawText("1. Easy", screenWidth / 2 - 100, screenHeight / 2 - 60, 20, WHITE);
-                DrawText("2. Normal", screenWidth / 2 - 100, screenHeight / 2 - 20, 20, WHITE);
-                DrawText("3. Hard", screenWidth / 2 - 100, screenHeight / 2 + 20, 20, WHITE);
-                DrawText("4. Timed", screenWidth / 2 - 100, screenHeight / 2 + 60, 20, WHITE);
-                
-                if (IsKeyPressed(KEY_ONE)) {
-                    currentMode = EASY;
-                    roastingSpeed = 0.8f;
-                    winScore = 50;
-                    currentScreen = GAMEPLAY;
-                } else if (IsKeyPressed(KEY_TWO)) {
-                    currentMode = NORMAL;
-                    roastingSpeed = 1.0f;
-                    winScore = 100;
-                    currentScreen = GAMEPLAY;
-                } else if (IsKeyPressed(KEY_THREE)) {
-                    currentMode = HARD;
-                    roastingSpeed = 1.5f;
-                    winScore = 150;
-                    currentScreen = GAMEPLAY;
-                } else if (IsKeyPressed(KEY_FOUR)) {
-                    currentMode = TIMED;
-                    roastingSpeed = 1.2f;
-                    winScore = 75;
-                    currentScreen = GAMEPLAY;
-                }
-                ResetGame();  // Reset game state
-                break;
-
-            case INSTRUCTIONS:
-                DrawText("Instructions: Roast marshmallows to score points.", screenWidth / 2 - 200, screenHeight / 2 - 50, 20, WHITE);
-                DrawText("Press Enter to return to the Title screen.", screenWidth / 2 - 200, screenHeight / 2, 20, WHITE);
-                if (IsKeyPressed(KEY_ENTER)) {
-                    currentScreen = TITLE;
-                }
-                break;
-
-            case NAME_INPUT: {
-                if (IsKeyPressed(KEY_BACKSPACE) && letterCount > 0) {
-                    playerName[--letterCount] = '\0';
-                }
-
-                int key = GetKeyPressed();
-                if (key >= 32 && key <= 125 && letterCount < 31) {
-                    playerName[letterCount++] = (char)key;
-                    playerName[letterCount] = '\0';
-                }
-
-                if (IsKeyPressed(KEY_ENTER) && letterCount > 0) {
-                    currentScreen = MODE_SELECT;
-                }
-
-                DrawText("Enter your name:", screenWidth / 2 - 150, screenHeight / 2 - 50, 20, DARKGRAY);
-                DrawText(playerName, screenWidth / 2 - 150, screenHeight / 2, 30, WHITE);
-                break;
-            }
-
-            case GAMEPLAY: {
-                Vector2 mousePos = GetMousePosition();
-
-                for (int i = 0; i < 4; i++) {
-                    UpdateMarshmallow(marshmallows[i], deltaTime, marshmallowTextures, roastingSpeed);
-
-                    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && IsMarshmallowClicked(marshmallows[i], mousePos)) {
-                        if (marshmallows[i].state == 2) {
-                            score += 5;
-                            PlaySound(clickSound);
-                        } else if (marshmallows[i].state == 1) {
-                            score += 1;
-                            PlaySound(clickSound);
-                        } else if (marshmallows[i].state == 3) {
-                            score -= 2;
-                            PlaySound(burnSound);
-                        }
-                        ResetMarshmallow(marshmallows[i], marshmallowTextures);
-                    }
-                }
-
-                if (currentMode == TIMED) {
-                    timeRemaining -= deltaTime;
-                    if (timeRemaining <= 0) {
-                        currentScreen = ENDING;
-                    }
-                }
-
-                if (score >= winScore || (currentMode == TIMED && timeRemaining <= 0)) {
-                    currentScreen = ENDING;
-                }
-                break;
-            }
+    // Upload what the loader threads have decoded; screens waiting on assets see it through the input
+    if (!IsAssetLoadingDone()) {
+        PROFILE_SCOPE(PROFILE_ASSETS);
+        if (UpdateAssetLoading()) {
+            // Burns matter more than clicks, which come in bursts
+            SetSfxVoices(SFX_CLICK, clickSound, 4, 0);
+            SetSfxVoices(SFX_BURN, burnSound, 2, 1);
+            PlayMixerMusic(backgroundMusic);
+        }
+    }
+    if (inputReplay.file == nullptr) {
+        if (IsAssetGroupLoaded(ASSET_GROUP_TITLE)) input.keys |= GAME_SIGNAL_TITLE_READY;
+        if (IsAssetGroupLoaded(ASSET_GROUP_GAMEPLAY)) input.keys |= GAME_SIGNAL_GAMEPLAY_READY;
+    }
+    RecordInputFrame(inputRecording, input, deltaTime);
+    if (IsKeyPressed(KEY_F3)) showProfiler = !showProfiler;
 
-            case ENDING:
-                InsertScore(playerName, score, timeRemaining, GetGameModeString(currentMode));
-                LoadLeaderboard(GetGameModeString(currentMode));  // Reload leaderboard based on game mode
+    {
+        PROFILE_SCOPE(PROFILE_MUSIC);
+        UpdateAudioMixer();     // Music is fed from its own thread except on the web
+    }
 
-                if (IsKeyPressed(KEY_ENTER)) {
-                    currentScreen = TITLE;
-                }
-                break;
+    // The simulation runs in fixed GAME_STEP_DT steps, as many as this frame's time covers
+    int steps;
+    {
+        PROFILE_SCOPE(PROFILE_LOGIC);
+        // Pick up leaderboard rows written by the persistence worker
+        const LeaderboardTable *snapshot = PersistencePollSnapshot();
+        if (snapshot != nullptr) {
+            leaderboardCache[snapshot->mode] = *snapshot;
+            leaderboardVersion++;
         }
 
+        steps = GameAdvance(game, input, deltaTime);
+        HandleGameEvents();
+    }
+
+    {
+        // Update parallax backgrounds, stepped with the simulation
+        PROFILE_SCOPE(PROFILE_PARALLAX);
+        for (int s = 0; s < steps; s++) UpdateParallax(parallax, GAME_STEP_DT);
+    }
+    float alpha = GetGameStepAlpha(game);   // Draw between the last two steps
     //----------------------------------------------------------------------------------
 
     // Draw
     //----------------------------------------------------------------------------------
+    ProfileScope drawScope(PROFILE_DRAW);
     BeginDrawing();
         ClearBackground(RAYWHITE);
 
          // Draw the parallax background layers
-        DrawParallaxLayers();
-
-        switch (currentScreen) {
-            case LOGO:
-                DrawText("LOGO SCREEN", screenWidth / 2 - 100, screenHeight / 2 - 20, 40, WHITE);
-                break;
-
-            case TITLE:
-                DrawTexture(background, 0, 0, WHITE);
-                DrawText("Marshmallow Roasting Game", screenWidth / 2 - 200, screenHeight / 2 - 20, 40, WHITE);
-                DrawText("Press Enter to Continue", screenWidth / 2 - 150, screenHeight / 2 + 40, 20, WHITE);
-                DrawText("Press 'L' to View Leaderboard", screenWidth / 2 - 150, screenHeight / 2 + 80, 20, WHITE);
-                if (displayLeaderboard) {
-                    DisplayLeaderboard();
-                }
-                break;
-
-            case INSTRUCTIONS:
-                DrawText("Instructions: Roast marshmallows to score points.", screenWidth / 2 - 200, screenHeight / 2 - 50, 20, WHITE);
-                DrawText("Press Enter to return to the Title screen.", screenWidth / 2 - 200, screenHeight / 2, 20, WHITE);
-                break;
-            
-
-            case NAME_INPUT: {
-                DrawText("Enter your name:", screenWidth / 2 - 150, screenHeight / 2 - 50, 20, DARKGRAY);
-                DrawText(playerName, screenWidth / 2 - 150, screenHeight / 2, 30, WHITE);
+        DrawParallax(parallax, alpha);
+
+        switch (game.screen) {
+            case LOGO: {
+                // Nothing is uploaded yet, so no parallax behind this
+                float progress = GetAssetGroupProgress(ASSET_GROUP_TITLE);
+                DrawTextQuick(GetUiFont(), "LOGO SCREEN", screenWidth / 2 - 100, screenHeight / 2 - 20, 40, DARKGRAY);
+                DrawRectangleLines(screenWidth / 2 - 150, screenHeight / 2 + 40, 300, 20, DARKGRAY);
+                DrawRectangle(screenWidth / 2 - 148, screenHeight / 2 + 42, (int)(296 * progress), 16, MAROON);
                 break;
             }
 
-            case LEADERBOARD_SELECTION:
-                DrawText("Select Leaderboard Mode", screenWidth / 2 - 150, screenHeight / 2 - 100, 30, WHITE);
-                DrawText("1. Easy", screenWidth / 2 - 100, screenHeight / 2 - 60, 20, WHITE);
-                DrawText("2. Normal", screenWidth / 2 - 100, screenHeight / 2 - 20, 20, WHITE);
-                DrawText("3. Hard", screenWidth / 2 - 100, screenHeight / 2 + 20, 20, WHITE);
-                DrawText("4. Timed", screenWidth / 2 - 100, screenHeight / 2 + 60, 20, WHITE);
-                break;
-
-            case MODE_SELECT:
-                DrawText("Select Game Mode", screenWidth / 2 - 100, screenHeight / 2 - 100, 30, WHITE);
-                DrawText("1. Easy", screenWidth / 2 - 100, screenHeight / 2 - 60, 20, WHITE);
-                DrawText("2. Normal", screenWidth / 2 - 100, screenHeight / 2 - 20, 20, WHITE);
-                DrawText("3. Hard", screenWidth / 2 - 100, screenHeight / 2 + 20, 20, WHITE);
-                DrawText("4. Timed", screenWidth / 2 - 100, screenHeight / 2 + 60, 20, WHITE);
-                break;
-
             case GAMEPLAY:
-                DrawTexture(background, 0, 0, WHITE);
-                DrawTexture(bonfireTexture, (screenWidth / 2) - 64, screenHeight - 128, WHITE);
-
-                for (int i = 0; i < 4; i++) {
-                    DrawTexture(platformTexture, 120, 250 + (i % 2) * 150, WHITE);
-                    DrawTexture(marshmallows[i].texture, marshmallows[i].position.x, marshmallows[i].position.y, WHITE);
+                // All sprites come from the atlas, so this is one batch
+                DrawSprite(atlas, SPRITE_BACKGROUND, 0, 0);
+                DrawSprite(atlas, SPRITE_BONFIRE, (screenWidth / 2) - 64, screenHeight - 128);
+
+                if (game.mode == SWARM) {
+                    DrawSwarm(alpha);
+                } else {
+                    const MarshmallowPool &pool = game.marshmallows;
+                    for (int i = 0; i < pool.count; i++) {
+                        DrawSprite(atlas, SPRITE_PLATFORM, 120, 250 + (i % 2) * 150);
+                        DrawSprite(atlas, (AtlasSprite)(SPRITE_MARSHMALLOW_WHITE + pool.state[i]), pool.x[i], pool.y[i]);
+                    }
                 }
 
-                DrawText(TextFormat("Score: %d", score), 10, 10, 20, WHITE);
-                if (currentMode == TIMED) {
-                    DrawText(TextFormat("Time: %.1f", timeRemaining), screenWidth - 150, 10, 20, WHITE);
+                // Only rebuilt when the text changes, otherwise a string compare and one batch of quads
+                ClearText(textBuffer);
+                AppendText(textBuffer, "Score: ");
+                AppendInt(textBuffer, game.score);
+                UpdateTextLayout(scoreLayout, GetUiFont(), textBuffer.text, 20);
+                DrawTextLayout(scoreLayout, GetUiFont(), 10, 10, WHITE);
+                if (game.mode == TIMED) {
+                    float timeRemaining = game.previousTimeRemaining + (game.timeRemaining - game.previousTimeRemaining) * alpha;
+                    ClearText(textBuffer);
+                    AppendText(textBuffer, "Time: ");
+                    AppendFloat(textBuffer, timeRemaining, 1);
+                    UpdateTextLayout(timeLayout, GetUiFont(), textBuffer.text, 20);
+                    DrawTextLayout(timeLayout, GetUiFont(), screenWidth - 150, 10, WHITE);
                 }
                 break;
 
-            case ENDING:
-                DrawText("Congratulations!", screenWidth / 2 - 200, screenHeight / 2 - 20, 40, WHITE);
-                DrawText(TextFormat("Your Score: %d", score), screenWidth / 2 - 100, screenHeight / 2 + 20, 30, WHITE);
-                DrawText("Press Enter to return to Title Screen", screenWidth / 2 - 250, screenHeight / 2 + 60, 20, WHITE);
-
-                DisplayLeaderboard();  // Show leaderboard on ending screen
+            default:
+                // Menus only change with the data they show; redrawn into the cache when that changes
+                DrawUiCache(menuCache, GetMenuCacheKey(), DrawMenuScreen);
                 break;
         }
 
-    EndDrawing();
+        if (showProfiler) DrawProfilerOverlay();
+
+    drawScope.End();
+    {
+        PROFILE_SCOPE(PROFILE_PRESENT);
+        EndDrawing();
+    }
+
+    ProfileEndFrame();
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "marshmallow_pool.h"
+#include <cmath>
+#include <cstring>
+
+// Cell holding a top-left corner, clamped to the grid
+static int GetGridCell(const MarshmallowPool &pool, float x, float y) {
+    int cx = (int)(x / pool.cellSize), cy = (int)(y / pool.cellSize);
+    if (cx < 0) cx = 0; else if (cx >= pool.gridColumns) cx = pool.gridColumns - 1;
+    if (cy < 0) cy = 0; else if (cy >= pool.gridRows) cy = pool.gridRows - 1;
+    return cy * pool.gridColumns + cx;
+}
+
+// Rebuild the grid by counting sort on each marshmallow's top-left cell
+static void BuildMarshmallowGrid(MarshmallowPool &pool) {
+    float maxX = pool.worldWidth, maxY = 0.0f;
+    for (int i = 0; i < pool.count; i++) {
+        if (pool.worldWidth <= 0.0f && pool.x[i] + 1.0f > maxX) maxX = pool.x[i] + 1.0f;
+        if (pool.y[i] + 1.0f > maxY) maxY = pool.y[i] + 1.0f;
+    }
+
+    // Cells at least a marshmallow wide, so a point only needs its own and the previous cells checked
+    pool.cellSize = 2.0f * MARSHMALLOW_SIZE;
+    for (;;) {
+        pool.gridColumns = (int)ceilf(maxX / pool.cellSize);
+        pool.gridRows = (int)ceilf(maxY / pool.cellSize);
+        if (pool.gridColumns < 1) pool.gridColumns = 1;
+        if (pool.gridRows < 1) pool.gridRows = 1;
+        if (pool.gridColumns * pool.gridRows <= MARSHMALLOW_GRID_CELLS_MAX) break;
+        pool.cellSize *= 2.0f;
+    }
+
+    // Count into cellStart[c], prefix-sum to each cell's end, then fill backwards so each
+    // cellStart[c] ends up at the cell's start with its items in index order
+    int cells = pool.gridColumns * pool.gridRows;
+    memset(pool.cellStart, 0, sizeof(pool.cellStart[0]) * (cells + 1));
+    for (int i = 0; i < pool.count; i++) pool.cellStart[GetGridCell(pool, pool.x[i], pool.y[i])]++;
+    for (int c = 1; c < cells; c++) pool.cellStart[c] += pool.cellStart[c - 1];
+    pool.cellStart[cells] = pool.count;
+    for (int i = pool.count - 1; i >= 0; i--) pool.cellItems[--pool.cellStart[GetGridCell(pool, pool.x[i], pool.y[i])]] = i;
+}
+
+void SetMarshmallowLayout(MarshmallowPool &pool, const float *x, const float *y, int count, float worldWidth) {
+    if (count > MARSHMALLOW_POOL_MAX) count = MARSHMALLOW_POOL_MAX;
+    pool.count = count;
+    pool.worldWidth = worldWidth;
+    memcpy(pool.x, x, sizeof(float) * count);
+    memcpy(pool.y, y, sizeof(float) * count);
+    ResetMarshmallows(pool);
+    BuildMarshmallowGrid(pool);
+}
+
+void ResetMarshmallows(MarshmallowPool &pool) {
+    memset(pool.roastTimer, 0, sizeof(float) * pool.count);
+    memset(pool.state, 0, pool.count);
+}
+
+void ResetMarshmallow(MarshmallowPool &pool, int index) {
+    pool.roastTimer[index] = 0.0f;
+    pool.state[index] = 0;
+}
+
+// One block of the update; the fixed trip count lets -O2 vectorize it without a scalar epilogue
+#define ROAST_BLOCK 16
+static inline void UpdateRoastBlock(float *__restrict timer, unsigned char *__restrict state, int count,
+                                    float step, float yellow, float brown, float burnt) {
+    for (int i = 0; i < count; i++) {
+        float t = timer[i] + step;
+        timer[i] = t;
+        state[i] = (unsigned char)((t > yellow) + (t > brown) + (t > burnt));
+    }
+}
+
+void UpdateMarshmallows(MarshmallowPool &pool, float deltaTime, float roastSpeed, const MarshmallowThresholds &thresholds) {
+    // Timers only grow between resets, so the state is just how many thresholds were passed
+    const float step = deltaTime * roastSpeed;
+    const float yellow = thresholds.yellowTime, brown = thresholds.brownTime, burnt = thresholds.burntTime;
+    const int count = pool.count;
+    int i = 0;
+    for (; i + ROAST_BLOCK <= count; i += ROAST_BLOCK) {
+        UpdateRoastBlock(pool.roastTimer + i, pool.state + i, ROAST_BLOCK, step, yellow, brown, burnt);
+    }
+    UpdateRoastBlock(pool.roastTimer + i, pool.state + i, count - i, step, yellow, brown, burnt);
+}
+
+// Same edges as raylib's CheckCollisionPointRec
+static void FindInCells(const MarshmallowPool &pool, float x, float y, int &best) {
+    int cx = (int)floorf(x / pool.cellSize), cy = (int)floorf(y / pool.cellSize);
+    for (int row = cy - 1; row <= cy; row++) {
+        if (row < 0 || row >= pool.gridRows) continue;
+        for (int column = cx - 1; column <= cx; column++) {
+            if (column < 0 || column >= pool.gridColumns) continue;
+            int cell = row * pool.gridColumns + column;
+            for (int k = pool.cellStart[cell]; k < pool.cellStart[cell + 1]; k++) {
+                int i = pool.cellItems[k];
+                if ((best < 0 || i < best) && x >= pool.x[i] && x < pool.x[i] + MARSHMALLOW_SIZE &&
+                    y >= pool.y[i] && y < pool.y[i] + MARSHMALLOW_SIZE) {
+                    best = i;
+                }
+            }
+        }
+    }
+}
+
+int FindMarshmallowAt(const MarshmallowPool &pool, float x, float y) {
+    int best = -1;
+    if (pool.worldWidth > 0.0f) {
+        x = fmodf(x, pool.worldWidth);
+        if (x < 0.0f) x += pool.worldWidth;
+        FindInCells(pool, x, y, best);
+        if (x < MARSHMALLOW_SIZE) FindInCells(pool, x + pool.worldWidth, y, best);    // Ones wrapping past the end
+    } else {
+        FindInCells(pool, x, y, best);
+    }
+    return best;
+}
+
+// Items whose span, moved by shift, overlaps [left, right)
+static int QueryShifted(const MarshmallowPool &pool, float left, float right, float shift, int *items, int count, int maxItems) {
+    float minX = left - shift - MARSHMALLOW_SIZE, maxX = right - shift;
+    int first = (int)floorf(minX / pool.cellSize), last = (int)floorf(maxX / pool.cellSize);
+    if (first < 0) first = 0;
+    if (last >= pool.gridColumns) last = pool.gridColumns - 1;
+    for (int row = 0; row < pool.gridRows; row++) {
+        for (int column = first; column <= last; column++) {
+            int cell = row * pool.gridColumns + column;
+            for (int k = pool.cellStart[cell]; k < pool.cellStart[cell + 1] && count < maxItems; k++) {
+                int i = pool.cellItems[k];
+                if (pool.x[i] > minX && pool.x[i] < maxX) items[count++] = i;
+            }
+        }
+    }
+    return count;
+}
+
+int QueryMarshmallows(const MarshmallowPool &pool, float left, float right, int *items, int maxItems) {
+    if (pool.worldWidth <= 0.0f) return QueryShifted(pool, left, right, 0.0f, items, 0, maxItems);
+
+    // Bring left into [0, worldWidth), then the view can see copies shifted either way
+    float wrap = floorf(left / pool.worldWidth) * pool.worldWidth;
+    left -= wrap;
+    right -= wrap;
+    int count = QueryShifted(pool, left, right, -pool.worldWidth, items, 0, maxItems);
+    count = QueryShifted(pool, left, right, 0.0f, items, count, maxItems);
+    return QueryShifted(pool, left, right, pool.worldWidth, items, count, maxItems);
+}
+
+float GetMarshmallowViewX(const MarshmallowPool &pool, int index, float left) {
+    float x = pool.x[index] - left;
+    if (pool.worldWidth > 0.0f) {
+        x = fmodf(x + MARSHMALLOW_SIZE, pool.worldWidth);
+        if (x < 0.0f) x += pool.worldWidth;
+        x -= MARSHMALLOW_SIZE;
+    }
+    return x;
+}
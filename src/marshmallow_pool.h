@@ -0,0 +1,66 @@
+#ifndef MARSHMALLOW_POOL_H
+#define MARSHMALLOW_POOL_H
+
+//----------------------------------------------------------------------------------
+// Marshmallow pool
+//----------------------------------------------------------------------------------
+// Structure of arrays: positions, roast timers and state bytes in separate
+// contiguous arrays, so the per-step roast update is one branchless loop the
+// compiler can vectorize (the Makefile builds this file at -O2 for that; on the
+// web it takes -msimd128 as well). The sprite is picked from the state at draw time.
+//
+// Click tests go through a uniform grid over the (static) world positions, keyed
+// by each marshmallow's top-left corner and rebuilt only when the layout changes.
+// Positions may wrap horizontally at worldWidth, for platforms that scroll.
+// No raylib dependency.
+
+#define MARSHMALLOW_SIZE 64
+#define MARSHMALLOW_POOL_MAX 16384
+#define MARSHMALLOW_GRID_CELLS_MAX 8192
+
+struct MarshmallowThresholds {
+    float yellowTime;               // Roast time before a marshmallow turns yellow
+    float brownTime;                // ... brown
+    float burntTime;                // ... burnt
+};
+
+struct MarshmallowPool {
+    int count;
+    float worldWidth;               // Positions wrap at this x, 0 if the layout doesn't scroll
+
+    float x[MARSHMALLOW_POOL_MAX];  // Top-left corner, world coordinates
+    float y[MARSHMALLOW_POOL_MAX];
+    float roastTimer[MARSHMALLOW_POOL_MAX];
+    unsigned char state[MARSHMALLOW_POOL_MAX];  // 0: white, 1: yellow, 2: brown, 3: black
+
+    // Uniform grid, cell c holds cellItems[cellStart[c] .. cellStart[c + 1])
+    float cellSize;
+    int gridColumns;
+    int gridRows;
+    int cellStart[MARSHMALLOW_GRID_CELLS_MAX + 1];
+    int cellItems[MARSHMALLOW_POOL_MAX];
+};
+
+// Replace the layout: count marshmallows at the given positions, all white.
+// worldWidth > 0 makes x wrap around. Rebuilds the grid.
+void SetMarshmallowLayout(MarshmallowPool &pool, const float *x, const float *y, int count, float worldWidth);
+
+// Every marshmallow back to white
+void ResetMarshmallows(MarshmallowPool &pool);
+void ResetMarshmallow(MarshmallowPool &pool, int index);
+
+// Advance every roast timer and recompute states from the thresholds
+void UpdateMarshmallows(MarshmallowPool &pool, float deltaTime, float roastSpeed, const MarshmallowThresholds &thresholds);
+
+// Lowest index marshmallow covering world point (x, y), -1 if none
+int FindMarshmallowAt(const MarshmallowPool &pool, float x, float y);
+
+// Marshmallows whose x span overlaps world range [left, right), wrapping if the layout does.
+// The range must be narrower than worldWidth - MARSHMALLOW_SIZE, so each shows up once.
+// Writes up to maxItems indices, returns how many were written.
+int QueryMarshmallows(const MarshmallowPool &pool, float left, float right, int *items, int maxItems);
+
+// x of a marshmallow relative to left, wrapped into [-MARSHMALLOW_SIZE, worldWidth - MARSHMALLOW_SIZE)
+float GetMarshmallowViewX(const MarshmallowPool &pool, int index, float left);
+
+#endif // MARSHMALLOW_POOL_H
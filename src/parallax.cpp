@@ -0,0 +1,167 @@
+#include "parallax.h"
+#include "assets.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+ParallaxSet GetDefaultParallaxSet(void) {
+    ParallaxSet set;
+    set.folder = "background 2";
+    set.count = 5;
+    const char *files[5] = { "Plan-5.png", "Plan-4.png", "Plan-3.png", "Plan-2.png", "Plan-1.png" };
+    const float speeds[5] = { 50.0f, 1.0f, 0.0f, 0.0f, 25.0f };
+    for (int i = 0; i < set.count; i++) {
+        set.files[i] = files[i];
+        set.speeds[i] = speeds[i];
+    }
+    return set;
+}
+
+// Depth key of a layer file name: Plan-<n>.png gives -n (further back first), <n>.png gives n.
+// False for anything else in the folder (the composite preview, orig*.png, sources).
+static bool GetLayerDepth(const char *fileName, int &depth) {
+    const char *digits = fileName;
+    bool plan = strncmp(fileName, "Plan-", 5) == 0;
+    if (plan) digits += 5;
+    if (*digits < '0' || *digits > '9') return false;
+    char *end = nullptr;
+    long n = strtol(digits, &end, 10);
+    if (strcmp(end, ".png") != 0) return false;
+    depth = plan ? -(int)n : (int)n;
+    return true;
+}
+
+bool ScanParallaxSet(const char *basePath, const char *folder, ParallaxSet &set) {
+    std::string path = std::string(basePath) + PARALLAX_DIR + folder;
+    if (!DirectoryExists(path.c_str())) return false;
+
+    FilePathList files = LoadDirectoryFiles(path.c_str());
+    std::pair<int, std::string> layers[PARALLAX_LAYERS_MAX];
+    int count = 0;
+    for (unsigned int i = 0; i < files.count && count < PARALLAX_LAYERS_MAX; i++) {
+        const char *name = GetFileName(files.paths[i]);
+        int depth = 0;
+        if (GetLayerDepth(name, depth)) layers[count++] = std::make_pair(depth, std::string(name));
+    }
+    UnloadDirectoryFiles(files);
+    if (count == 0) return false;
+
+    // The back layer stays put, each one in front of it moves a bit faster
+    std::sort(layers, layers + count);
+    set.folder = folder;
+    set.count = count;
+    for (int i = 0; i < count; i++) {
+        set.files[i] = layers[i].second;
+        set.speeds[i] = i * PARALLAX_DEPTH_SPEED;
+    }
+    return true;
+}
+
+#if defined(PARALLAX_POT_SCROLLING)
+static int NextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+#endif
+
+bool LoadParallaxImages(const char *basePath, const ParallaxSet &set, ParallaxImages &images) {
+    images.count = 0;
+    for (int i = 0; i < set.count; i++) {
+        Image layer = LoadSourceImage(basePath, (std::string(PARALLAX_DIR) + set.folder + "/" + set.files[i]).c_str());
+        if (layer.data == nullptr) {
+            UnloadParallaxImages(images);
+            return false;
+        }
+
+        // A static layer right in front of another static one is drawn into it, so the run costs one pass
+        bool merge = set.speeds[i] == 0.0f && images.count > 0 && images.speeds[images.count - 1] == 0.0f;
+        if (merge) {
+            Image &target = images.images[images.count - 1];
+            ImageDraw(&target, layer, (Rectangle){ 0, 0, (float)layer.width, (float)layer.height },
+                      (Rectangle){ 0, 0, (float)target.width, (float)target.height }, WHITE);
+            UnloadImage(layer);
+        } else {
+            ImageFormat(&layer, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            images.images[images.count] = layer;
+            images.speeds[images.count] = set.speeds[i];
+            images.count++;
+        }
+    }
+
+    for (int i = 0; i < images.count; i++) {
+        // Only draw where the layer has any alpha; scrolling layers keep their full width
+        Image &image = images.images[i];
+        Rectangle border = GetImageAlphaBorder(image, 0.0f);
+        images.bounds[i] = (Rectangle){ border.x / image.width, border.y / image.height,
+                                        border.width / image.width, border.height / image.height };
+        if (images.speeds[i] != 0.0f) {
+            images.bounds[i].x = 0.0f;
+            images.bounds[i].width = 1.0f;
+#if defined(PARALLAX_POT_SCROLLING)
+            ImageResize(&image, NextPowerOfTwo(image.width), NextPowerOfTwo(image.height));
+#endif
+        }
+    }
+    return true;
+}
+
+void UnloadParallaxImages(ParallaxImages &images) {
+    for (int i = 0; i < images.count; i++) UnloadImage(images.images[i]);
+    images.count = 0;
+}
+
+void UploadParallax(ParallaxImages &images, ParallaxBackground &background, float width, float height) {
+    UnloadParallax(background);
+    background.width = width;
+    background.height = height;
+    for (int i = 0; i < images.count; i++) {
+        ParallaxLayer &layer = background.layers[i];
+        layer.texture = LoadTextureFromImage(images.images[i]);
+        SetTextureFilter(layer.texture, TEXTURE_FILTER_BILINEAR);   // Layers are scaled up to the screen
+        if (images.speeds[i] != 0.0f) SetTextureWrap(layer.texture, TEXTURE_WRAP_REPEAT);
+        layer.speed = images.speeds[i];
+        layer.bounds = images.bounds[i];
+        layer.scrollingOffset = 0.0f;
+        layer.previousOffset = 0.0f;
+    }
+    background.count = images.count;
+    UnloadParallaxImages(images);
+}
+
+void UnloadParallax(ParallaxBackground &background) {
+    for (int i = 0; i < background.count; i++) UnloadTexture(background.layers[i].texture);
+    background.count = 0;
+}
+
+void UpdateParallax(ParallaxBackground &background, float deltaTime) {
+    for (int i = 0; i < background.count; i++) {
+        ParallaxLayer &layer = background.layers[i];
+        layer.previousOffset = layer.scrollingOffset;
+        if (layer.speed == 0.0f) continue;
+        layer.scrollingOffset -= layer.speed * deltaTime;
+        if (layer.scrollingOffset <= -background.width) {
+            // Wrap both so interpolation doesn't sweep back across the whole screen
+            layer.scrollingOffset += background.width;
+            layer.previousOffset += background.width;
+        }
+    }
+}
+
+void DrawParallax(const ParallaxBackground &background, float alpha) {
+    for (int i = 0; i < background.count; i++) {
+        const ParallaxLayer &layer = background.layers[i];
+        if (layer.bounds.width <= 0.0f || layer.bounds.height <= 0.0f) continue;
+        const Texture2D &texture = layer.texture;
+
+        // Same area of the texture and the screen, shifted along u by the offset when scrolling;
+        // the repeat wrap fills in what scrolls off the left edge
+        float offset = layer.previousOffset + (layer.scrollingOffset - layer.previousOffset) * alpha;
+        Rectangle source = { layer.bounds.x * texture.width - offset / background.width * texture.width,
+                             layer.bounds.y * texture.height,
+                             layer.bounds.width * texture.width, layer.bounds.height * texture.height };
+        Rectangle dest = { layer.bounds.x * background.width, layer.bounds.y * background.height,
+                           layer.bounds.width * background.width, layer.bounds.height * background.height };
+        DrawTexturePro(texture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+    }
+}
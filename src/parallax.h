@@ -0,0 +1,76 @@
+#ifndef PARALLAX_H
+#define PARALLAX_H
+
+#include "raylib.h"
+#include <string>
+
+//----------------------------------------------------------------------------------
+// Parallax background
+//----------------------------------------------------------------------------------
+// A set is a folder of layer images drawn back to front, each stretched over the
+// screen and scrolling left at its own speed. To keep fill rate down:
+//  - runs of adjacent static layers are composited into one image at load time
+//  - a scrolling layer is one quad with TEXTURE_WRAP_REPEAT and a UV offset,
+//    instead of two side-by-side copies
+//  - every layer only covers the rows (static: the rectangle) where its alpha
+//    is non-zero, so mostly transparent layers cost a fraction of a pass
+// Images are built on the CPU (LoadParallaxImages(), safe on a loader thread) and
+// uploaded by UploadParallax() on the main thread.
+
+#define PARALLAX_DIR "resources/textures/parallax/"
+#define PARALLAX_LAYERS_MAX 8
+#define PARALLAX_DEPTH_SPEED 12.0f      // Scanned sets: pixels per second added per layer in front of the back one
+
+// GLES2/WebGL1 only repeat power-of-two textures
+#if defined(PLATFORM_WEB) || defined(PLATFORM_RPI) || defined(PLATFORM_DRM) || defined(PLATFORM_ANDROID)
+    #define PARALLAX_POT_SCROLLING 1
+#endif
+
+struct ParallaxSet {
+    std::string folder;                         // Under PARALLAX_DIR
+    int count;
+    std::string files[PARALLAX_LAYERS_MAX];     // Back to front, relative to the folder
+    float speeds[PARALLAX_LAYERS_MAX];          // Screen pixels per second, 0 for static
+};
+
+// CPU side of a loaded set, after compositing
+struct ParallaxImages {
+    int count;
+    Image images[PARALLAX_LAYERS_MAX];
+    float speeds[PARALLAX_LAYERS_MAX];
+    Rectangle bounds[PARALLAX_LAYERS_MAX];      // Covered area, as fractions of the image
+};
+
+struct ParallaxLayer {
+    Texture2D texture;
+    float speed;
+    Rectangle bounds;                           // Covered area, as fractions of the screen
+    float scrollingOffset;                      // Screen pixels, in (-width, 0]
+    float previousOffset;                       // Before the last step, drawn offset is interpolated between the two
+};
+
+struct ParallaxBackground {
+    int count;                                  // 0 until uploaded
+    float width;
+    float height;
+    ParallaxLayer layers[PARALLAX_LAYERS_MAX];
+};
+
+// "background 2" with the speeds the game has always used
+ParallaxSet GetDefaultParallaxSet(void);
+
+// Layers found in a set folder, with speeds growing towards the front: Plan-<n>.png
+// (highest n at the back) or <n>.png (lowest n at the back). False if none found.
+bool ScanParallaxSet(const char *basePath, const char *folder, ParallaxSet &set);
+
+bool LoadParallaxImages(const char *basePath, const ParallaxSet &set, ParallaxImages &images);
+void UnloadParallaxImages(ParallaxImages &images);
+
+// Upload and take ownership of the images (they are unloaded)
+void UploadParallax(ParallaxImages &images, ParallaxBackground &background, float width, float height);
+void UnloadParallax(ParallaxBackground &background);
+
+void UpdateParallax(ParallaxBackground &background, float deltaTime);
+void DrawParallax(const ParallaxBackground &background, float alpha);
+
+#endif // PARALLAX_H
@@ -0,0 +1,276 @@
+#include "persistence.h"
+#include "leaderboard_net.h"
+#include "lockfree_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+#else
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+#endif
+
+// Score record queued by the render thread
+struct ScoreRecord {
+    char name[32];
+    int score;
+    float time;
+    GameMode mode;
+};
+
+static BoundedQueue<ScoreRecord, 64> submitQueue;
+
+// Double-buffered snapshot: the worker only fills buffers[1 - front] while snapshotReady
+// is false, the render thread flips front when it sees snapshotReady and clears it
+static LeaderboardTable snapshots[2];
+static std::atomic<int> frontSnapshot(0);
+static std::atomic<bool> snapshotReady(false);
+
+#if !defined(PLATFORM_WEB)
+static std::thread worker;
+static std::mutex wakeMutex;
+static std::condition_variable wakeSignal;
+static std::atomic<bool> running(false);
+
+// Server mode: scores go to tools/leaderboard_server and tables come back from it
+static int serverPort = 0;                      // 0: write the local database
+static std::string fallbackPath;                // Where scores the server never acknowledged end up
+static NetConnection server = { -1, 0, {} };
+static NetScore inFlight[PERSISTENCE_IN_FLIGHT_MAX];   // Sent but not acknowledged, oldest first
+static int inFlightCount = 0;
+#else
+static bool writeScheduled = false;     // A WebWriteTask is queued
+#endif
+
+// Write every queued score, returns the mode of the last one written (-1 if none)
+static int WritePendingScores(void) {
+    int lastMode = -1;
+    ScoreRecord record;
+    if (!submitQueue.Pop(record)) return lastMode;
+
+    BeginScoreBatch();
+    do {
+        InsertScore(record.name, record.score, record.time, record.mode);
+        lastMode = record.mode;
+    } while (submitQueue.Pop(record));
+    CommitScoreBatch();
+    return lastMode;
+}
+
+// Fill the back buffer with the given mode's leaderboard and hand it to the render thread
+static void PublishSnapshot(GameMode mode) {
+    LeaderboardTable &back = snapshots[1 - frontSnapshot.load(std::memory_order_acquire)];
+    LoadLeaderboard(mode, back);
+    snapshotReady.store(true, std::memory_order_release);
+}
+
+#if defined(PLATFORM_WEB)
+static void WebWriteTask(void *);
+
+static void ScheduleWebWrite(int delayMs) {
+    if (writeScheduled) return;
+    writeScheduled = true;
+    emscripten_async_call(WebWriteTask, nullptr, delayMs);     // setTimeout, not the animation frame
+}
+
+// Browser task queued by PersistenceSubmitScore(): runs after the frame callback returns,
+// so the journal write and the IndexedDB sync it starts never land inside a frame
+static void WebWriteTask(void *) {
+    writeScheduled = false;
+    if (snapshotReady.load()) {
+        ScheduleWebWrite(PERSISTENCE_WEB_RETRY_MS);    // The last snapshot hasn't been picked up yet
+        return;
+    }
+    int mode = WritePendingScores();
+    if (mode >= 0) PublishSnapshot((GameMode)mode);
+}
+#else
+// The render thread consumes snapshots once per frame, wait until the back buffer is free.
+// False if stopping first.
+static bool WaitForSnapshotSlot(void) {
+    while (snapshotReady.load(std::memory_order_acquire) && running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return !snapshotReady.load(std::memory_order_acquire);
+}
+
+static void WorkerLoop(void) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeSignal.wait(lock, []{ return !submitQueue.Empty() || !running.load(); });
+        }
+
+        int mode = WritePendingScores();
+        if (mode >= 0 && WaitForSnapshotSlot()) PublishSnapshot((GameMode)mode);
+
+        if (!running.load() && submitQueue.Empty()) break;
+    }
+}
+
+// (Re)connect, subscribe, and resend whatever the last connection didn't acknowledge
+static bool ConnectServer(void) {
+    if (!OpenNetConnection(server, serverPort) || !SendNetSubscribe(server)) return false;
+    return inFlightCount == 0 || SendNetScores(server, inFlight, inFlightCount);
+}
+
+// Send queued scores as one batch, keeping them until the server acknowledges them
+static void SendPendingScores(void) {
+    int first = inFlightCount;
+    ScoreRecord record;
+    while (inFlightCount < PERSISTENCE_IN_FLIGHT_MAX && submitQueue.Pop(record)) {
+        inFlight[inFlightCount++] = MakeNetScore(record.name, record.score, record.time, record.mode);
+    }
+    if (inFlightCount > first) SendNetScores(server, inFlight + first, inFlightCount - first);
+}
+
+// Apply acknowledgements and hand pushed tables to the render thread
+static void HandleServerMessage(const NetMessage &message) {
+    if (message.type == NET_MSG_ACK) {
+        int acked = (message.count < inFlightCount) ? message.count : inFlightCount;
+        inFlightCount -= acked;
+        memmove(inFlight, inFlight + acked, inFlightCount * sizeof(NetScore));
+    } else if (message.type == NET_MSG_TABLE) {
+        LeaderboardTable table;
+        if (ReadNetTable(message.table, table) && WaitForSnapshotSlot()) {
+            snapshots[1 - frontSnapshot.load(std::memory_order_acquire)] = table;
+            snapshotReady.store(true, std::memory_order_release);
+        }
+    }
+}
+
+// Write what the server never acknowledged to the local database, so shutting down
+// while it is unreachable (or slow) loses nothing. Scores it did commit are written
+// again, which is harmless: only a better score replaces a stored one.
+static void SaveUndeliveredScores(void) {
+    if (inFlightCount == 0 && submitQueue.Empty()) return;
+
+    SetLeaderboardStorage(GetLeaderboardStorageFor(fallbackPath.c_str()));
+    bool opened = InitDatabase(fallbackPath.c_str());
+    if (opened) BeginScoreBatch();
+    int count = 0;
+    for (int i = 0; i < inFlightCount; i++, count++) {
+        if (opened) InsertScore(inFlight[i].name, inFlight[i].score, inFlight[i].time, (GameMode)inFlight[i].mode);
+    }
+    inFlightCount = 0;
+    ScoreRecord record;
+    for (; submitQueue.Pop(record); count++) {
+        if (opened) InsertScore(record.name, record.score, record.time, record.mode);
+    }
+
+    if (!opened) {
+        fprintf(stderr, "Leaderboard: can't open %s (%s), %d unacknowledged scores lost\n",
+                fallbackPath.c_str(), GetDatabaseError(), count);
+        return;
+    }
+    CommitScoreBatch();
+    CloseDatabase();
+    fprintf(stderr, "Leaderboard: server didn't acknowledge %d scores, saved them to %s\n", count, fallbackPath.c_str());
+}
+
+static void ServerWorkerLoop(void) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point lastAttempt = Clock::now(), stopDeadline;
+    for (;;) {
+        {
+            // Wake for queued scores only when they can go out; otherwise sleep until the
+            // next reconnect attempt, or the poll interval to pick up pushed tables
+            std::chrono::milliseconds timeout(PERSISTENCE_SERVER_POLL_MS);
+            if (server.socket < 0) {
+                Clock::duration untilRetry = lastAttempt + std::chrono::milliseconds(PERSISTENCE_RECONNECT_MS) - Clock::now();
+                timeout = std::max(std::chrono::milliseconds(1), std::chrono::duration_cast<std::chrono::milliseconds>(untilRetry));
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeSignal.wait_for(lock, timeout, [&stopDeadline]{
+                bool canSend = server.socket >= 0 && inFlightCount < PERSISTENCE_IN_FLIGHT_MAX && !submitQueue.Empty();
+                bool stopRequested = !running.load() && stopDeadline == Clock::time_point();
+                return canSend || stopRequested;
+            });
+        }
+
+        if (server.socket < 0 && Clock::now() - lastAttempt >= std::chrono::milliseconds(PERSISTENCE_RECONNECT_MS)) {
+            lastAttempt = Clock::now();
+            ConnectServer();
+        }
+        if (server.socket >= 0) {
+            SendPendingScores();
+            NetMessage message;
+            while (ReceiveNetMessage(server, message, 0) == 1) HandleServerMessage(message);
+        }
+
+        // On stop, give the server a moment to acknowledge the last scores
+        if (!running.load()) {
+            if (stopDeadline == Clock::time_point()) stopDeadline = Clock::now() + std::chrono::milliseconds(PERSISTENCE_STOP_WAIT_MS);
+            bool flushed = submitQueue.Empty() && inFlightCount == 0;
+            if (flushed || server.socket < 0 || Clock::now() >= stopDeadline) break;
+        }
+    }
+    CloseNetConnection(server);
+    SaveUndeliveredScores();
+}
+#endif
+
+bool PersistenceConnect(int port, const char *localPath) {
+#if !defined(PLATFORM_WEB)
+    serverPort = port;
+    fallbackPath = localPath;
+    if (ConnectServer()) return true;
+    serverPort = 0;
+#endif
+    return false;
+}
+
+void PersistenceStart(void) {
+#if !defined(PLATFORM_WEB)
+    running.store(true);
+    worker = std::thread((serverPort > 0) ? ServerWorkerLoop : WorkerLoop);
+#endif
+}
+
+void PersistenceStop(void) {
+#if !defined(PLATFORM_WEB)
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running.store(false);
+    }
+    wakeSignal.notify_one();
+    worker.join();
+#else
+    WritePendingScores();
+#endif
+}
+
+bool PersistenceSubmitScore(const char *name, int score, float time, GameMode mode) {
+    ScoreRecord record;
+    strncpy(record.name, name, sizeof(record.name) - 1);
+    record.name[sizeof(record.name) - 1] = '\0';
+    record.mode = mode;
+    record.score = score;
+    record.time = time;
+
+    if (!submitQueue.Push(record)) return false;
+
+#if defined(PLATFORM_WEB)
+    ScheduleWebWrite(0);
+#else
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wakeSignal.notify_one();
+#endif
+    return true;
+}
+
+const LeaderboardTable *PersistencePollSnapshot(void) {
+    if (!snapshotReady.load(std::memory_order_acquire)) return nullptr;
+
+    int front = 1 - frontSnapshot.load(std::memory_order_relaxed);
+    frontSnapshot.store(front, std::memory_order_release);
+    snapshotReady.store(false, std::memory_order_release);
+    return &snapshots[front];
+}
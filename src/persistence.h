@@ -0,0 +1,46 @@
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include "leaderboard.h"
+
+//----------------------------------------------------------------------------------
+// Score persistence worker
+//----------------------------------------------------------------------------------
+// Finished games are pushed on a lock-free queue and written by a background
+// thread, so the render thread never waits on SQLite. After each write the worker
+// reloads the affected mode's leaderboard into the back half of a double buffer;
+// the render thread picks it up with PersistencePollSnapshot() and uses it to
+// refresh its resident copy of that mode's table.
+// On PLATFORM_WEB (no pthreads) the queue is drained by a browser task that
+// PersistenceSubmitScore() schedules, so writes happen between frames and never
+// inside the main loop callback.
+//
+// After PersistenceConnect() the worker talks to tools/leaderboard_server instead
+// of the database: queued scores go out as one batch, stay in flight until the
+// server acknowledges their commit (and are resent after a reconnect), and the
+// tables the server pushes become the snapshots. Whatever the server hasn't
+// acknowledged when PersistenceStop() gives up on it is written to the local
+// database instead. Not available on the web.
+
+#define PERSISTENCE_IN_FLIGHT_MAX 64    // Scores sent and not yet acknowledged
+#define PERSISTENCE_SERVER_POLL_MS 20   // How often the worker checks for pushed tables
+#define PERSISTENCE_RECONNECT_MS 1000
+#define PERSISTENCE_STOP_WAIT_MS 1000   // PersistenceStop() waits this long for the last acknowledgements
+#define PERSISTENCE_WEB_RETRY_MS 16     // Web: wait for the render thread to take the last snapshot
+
+// Use the leaderboard server on localhost:port instead of the database, before PersistenceStart().
+// False (and the database stays in use) if it can't be reached. localPath is the database
+// unacknowledged scores are saved to on stop.
+bool PersistenceConnect(int port, const char *localPath);
+
+void PersistenceStart(void);                    // Spawn the writer thread (database must be open)
+void PersistenceStop(void);                     // Flush pending scores and join the writer thread
+
+// Queue one finished game, false if the queue is full
+bool PersistenceSubmitScore(const char *name, int score, float time, GameMode mode);
+
+// Returns the newest snapshot if one was published since the last call, nullptr otherwise.
+// The pointer stays valid until the next call. Render thread only.
+const LeaderboardTable *PersistencePollSnapshot(void);
+
+#endif // PERSISTENCE_H
@@ -0,0 +1,124 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static ProfileFrame history[PROFILE_HISTORY];
+static long frameCount = 0;                     // Frames completed, history[frameCount % PROFILE_HISTORY] is the current one
+static ProfileFrame *current = nullptr;
+static std::chrono::steady_clock::time_point frameStart;
+
+static ProfileStats stats[PROFILE_PHASE_COUNT];
+static ProfileStats screenStats[GAME_SCREEN_COUNT][PROFILE_PHASE_COUNT];
+static long statsFrame = -PROFILE_STATS_INTERVAL;   // frameCount when stats were last computed
+
+static std::string traceFileName;
+
+const char *GetProfilePhaseString(ProfilePhase phase) {
+    switch (phase) {
+        case PROFILE_FRAME: return "frame";
+        case PROFILE_ASSETS: return "assets";
+        case PROFILE_MUSIC: return "music";
+        case PROFILE_PARALLAX: return "parallax";
+        case PROFILE_LOGIC: return "logic";
+        case PROFILE_DRAW: return "draw";
+        case PROFILE_PRESENT: return "present";
+        default: return "unknown";
+    }
+}
+
+void ProfileBeginFrame(GameScreen screen) {
+    current = &history[frameCount % PROFILE_HISTORY];
+    memset(current, 0, sizeof(*current));
+    current->frame = frameCount;
+    current->screen = screen;
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void ProfileEndFrame(void) {
+    if (current == nullptr) return;
+    current->ms[PROFILE_FRAME] = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+    current = nullptr;
+    frameCount++;
+}
+
+void ProfileAddTime(ProfilePhase phase, float ms) {
+    if (current != nullptr) current->ms[phase] += ms;
+}
+
+// p50/p99/max of values, which gets reordered
+static ProfileStats ComputeStats(std::vector<float> &values) {
+    ProfileStats result = {};
+    result.samples = (int)values.size();
+    if (values.empty()) return result;
+
+    size_t p50 = (values.size() - 1) / 2;
+    size_t p99 = (values.size() - 1) * 99 / 100;
+    std::nth_element(values.begin(), values.begin() + p50, values.end());
+    result.p50 = values[p50];
+    std::nth_element(values.begin() + p50, values.begin() + p99, values.end());
+    result.p99 = values[p99];
+    result.max = *std::max_element(values.begin() + p99, values.end());
+    return result;
+}
+
+static void UpdateStats(void) {
+    if (frameCount - statsFrame < PROFILE_STATS_INTERVAL) return;
+    statsFrame = frameCount;
+
+    long count = std::min<long>(frameCount, std::min(PROFILE_STATS_FRAMES, PROFILE_HISTORY));
+    std::vector<float> all, byScreen[GAME_SCREEN_COUNT];
+    all.reserve(count);
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        all.clear();
+        for (int s = 0; s < GAME_SCREEN_COUNT; s++) byScreen[s].clear();
+        for (long i = frameCount - count; i < frameCount; i++) {
+            const ProfileFrame &frame = history[i % PROFILE_HISTORY];
+            all.push_back(frame.ms[p]);
+            byScreen[frame.screen].push_back(frame.ms[p]);
+        }
+        stats[p] = ComputeStats(all);
+        for (int s = 0; s < GAME_SCREEN_COUNT; s++) screenStats[s][p] = ComputeStats(byScreen[s]);
+    }
+}
+
+ProfileStats GetProfileStats(ProfilePhase phase) {
+    UpdateStats();
+    return stats[phase];
+}
+
+ProfileStats GetProfileScreenStats(ProfilePhase phase, GameScreen screen) {
+    UpdateStats();
+    return screenStats[screen][phase];
+}
+
+bool OpenProfileTrace(const char *fileName) {
+    // Check now that the file can be written, rather than finding out on exit
+    FILE *file = fopen(fileName, "w");
+    if (file == nullptr) return false;
+    fclose(file);
+    traceFileName = fileName;
+    return true;
+}
+
+void CloseProfileTrace(void) {
+    if (traceFileName.empty()) return;
+    FILE *file = fopen(traceFileName.c_str(), "w");
+    traceFileName.clear();
+    if (file == nullptr) return;
+
+    fprintf(file, "frame,screen");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) fprintf(file, ",%s_ms", GetProfilePhaseString((ProfilePhase)p));
+    fprintf(file, "\n");
+
+    long first = std::max(0L, frameCount - PROFILE_HISTORY);
+    for (long i = first; i < frameCount; i++) {
+        const ProfileFrame &frame = history[i % PROFILE_HISTORY];
+        fprintf(file, "%ld,%s", frame.frame, GetGameScreenString(frame.screen));
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) fprintf(file, ",%.3f", frame.ms[p]);
+        fprintf(file, "\n");
+    }
+    fclose(file);
+}
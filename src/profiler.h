@@ -0,0 +1,82 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "game_state.h"
+#include <chrono>
+
+//----------------------------------------------------------------------------------
+// Frame profiler
+//----------------------------------------------------------------------------------
+// Scoped timers add their elapsed time to the current frame's record; each frame
+// is one slot in a ring buffer tagged with the GameScreen it ran on. The overlay
+// reads p50/p99/max from the most recent PROFILE_STATS_FRAMES frames, and with
+// `--trace file.csv` the whole ring is written out on exit.
+// Main thread only. No raylib dependency.
+
+typedef enum ProfilePhase {
+    PROFILE_FRAME = 0,      // Whole UpdateDrawFrame()
+    PROFILE_ASSETS,         // Asset uploads
+    PROFILE_MUSIC,          // UpdateMusicStream
+    PROFILE_PARALLAX,       // Parallax layer update
+    PROFILE_LOGIC,          // Snapshot poll, GameStep and its events (sound, score submission)
+    PROFILE_DRAW,           // Draw calls up to EndDrawing
+    PROFILE_PRESENT,        // EndDrawing: batch flush, swap and frame limiter wait
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+#define PROFILE_HISTORY 16384       // Frames kept for the trace, about 4.5 minutes at 60 fps
+#define PROFILE_STATS_FRAMES 600    // Frames the overlay statistics cover
+
+struct ProfileFrame {
+    long frame;
+    GameScreen screen;
+    float ms[PROFILE_PHASE_COUNT];
+};
+
+struct ProfileStats {
+    float p50;
+    float p99;
+    float max;
+    int samples;
+};
+
+const char *GetProfilePhaseString(ProfilePhase phase);
+
+void ProfileBeginFrame(GameScreen screen);
+void ProfileEndFrame(void);
+void ProfileAddTime(ProfilePhase phase, float ms);
+
+// Time from construction to end of scope goes to the current frame
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase phase) : phase(phase), running(true), start(std::chrono::steady_clock::now()) {}
+    ~ProfileScope() { End(); }
+
+    // Stop early, for phases that don't end with a block
+    void End() {
+        if (!running) return;
+        running = false;
+        ProfileAddTime(phase, std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    ProfilePhase phase;
+    bool running;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define PROFILE_SCOPE_NAME(line) profileScope##line
+#define PROFILE_SCOPE_LINE(phase, line) ProfileScope PROFILE_SCOPE_NAME(line)(phase)
+#define PROFILE_SCOPE(phase) PROFILE_SCOPE_LINE(phase, __LINE__)
+
+// Statistics over the last PROFILE_STATS_FRAMES frames, all screens or only frames on
+// one screen. Recomputed every PROFILE_STATS_INTERVAL frames, so cheap to call per frame.
+#define PROFILE_STATS_INTERVAL 30
+ProfileStats GetProfileStats(ProfilePhase phase);
+ProfileStats GetProfileScreenStats(ProfilePhase phase, GameScreen screen);
+
+// CSV of every frame still in the ring, written by CloseProfileTrace()
+bool OpenProfileTrace(const char *fileName);
+void CloseProfileTrace(void);
+
+#endif // PROFILER_H
@@ -0,0 +1,192 @@
+#include "text.h"
+#include "rlgl.h"
+#include <cstring>
+
+Image LoadTextFontImage(const char *fileName, Color key, TextFont &font) {
+    font = TextFont();
+    Image image = LoadImage(fileName);
+    if (image.data == nullptr) return image;
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    const Color *pixels = (const Color *)image.data;
+    int width = image.width, height = image.height;
+#define IS_KEY(x, y) (memcmp(&pixels[(y) * width + (x)], &key, sizeof(Color)) == 0)
+
+    // The first non-key pixel gives the gap around cells, the first cell's height the line height
+    int gap = 0;
+    while (gap < width && gap < height && IS_KEY(gap, gap)) gap++;
+    int cellHeight = 0;
+    while (gap + cellHeight < height && !IS_KEY(gap, gap + cellHeight)) cellHeight++;
+
+    // Cells run left to right, lines top to bottom, in character order from TEXT_FIRST_CHAR
+    int count = 0;
+    for (int y = gap; cellHeight > 0 && y + cellHeight <= height && count < TEXT_GLYPH_COUNT; y += cellHeight + gap) {
+        int x = gap;
+        while (x < width && !IS_KEY(x, y) && count < TEXT_GLYPH_COUNT) {
+            int cellWidth = 0;
+            while (x + cellWidth < width && !IS_KEY(x + cellWidth, y)) cellWidth++;
+            font.glyphs[count++] = (Rectangle){ (float)x, (float)y, (float)cellWidth, (float)cellHeight };
+            x += cellWidth + gap;
+        }
+    }
+#undef IS_KEY
+    if (count < TEXT_GLYPH_COUNT) TraceLog(LOG_WARNING, "Font %s has %d of %d glyphs", fileName, count, TEXT_GLYPH_COUNT);
+
+    ImageColorReplace(&image, key, BLANK);
+    font.baseSize = (float)cellHeight;
+    font.spacing = 0.0f;        // Cells already include the space between glyphs
+    return image;
+}
+
+void UploadTextFont(Image &image, TextFont &font) {
+    font.texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    image = Image();
+
+    // Drawn at a third of its size or less, so mipmaps where GLES2 allows them
+    bool powerOfTwo = (font.texture.width & (font.texture.width - 1)) == 0 && (font.texture.height & (font.texture.height - 1)) == 0;
+    if (powerOfTwo) {
+        GenTextureMipmaps(&font.texture);
+        SetTextureFilter(font.texture, TEXTURE_FILTER_TRILINEAR);
+    } else {
+        SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+    }
+}
+
+void UnloadTextFont(TextFont &font) {
+    UnloadTexture(font.texture);
+    font = TextFont();
+}
+
+TextFont GetDefaultTextFont(void) {
+    Font source = GetFontDefault();
+    TextFont font = {};
+    font.texture = source.texture;
+    font.baseSize = (float)source.baseSize;
+    font.spacing = 1.0f;        // DrawText() spaces by fontSize/10 with a base size of 10
+    for (int i = 0; i < TEXT_GLYPH_COUNT && i < source.glyphCount; i++) font.glyphs[i] = source.recs[i];
+    return font;
+}
+
+bool UpdateTextLayout(TextLayout &layout, const TextFont &font, const char *text, float fontSize) {
+    if (layout.textureId == font.texture.id && layout.fontSize == fontSize &&
+        strncmp(layout.text, text, TEXT_CHARS_MAX) == 0) return false;
+
+    strncpy(layout.text, text, TEXT_CHARS_MAX);
+    layout.text[TEXT_CHARS_MAX] = '\0';
+    layout.textureId = font.texture.id;
+    layout.fontSize = fontSize;
+    layout.quadCount = 0;
+    layout.width = 0.0f;
+    layout.height = fontSize;
+    if (font.texture.id == 0 || font.baseSize <= 0.0f) return true;
+
+    float scale = fontSize / font.baseSize;
+    float textureWidth = (float)font.texture.width, textureHeight = (float)font.texture.height;
+    float x = 0.0f, y = 0.0f;
+    for (const char *c = layout.text; *c != '\0'; c++) {
+        if (*c == '\n') {
+            x = 0.0f;
+            y += fontSize * 1.5f;
+            layout.height = y + fontSize;
+            continue;
+        }
+        int index = (unsigned char)*c - TEXT_FIRST_CHAR;
+        if (index < 0 || index >= TEXT_GLYPH_COUNT) index = '?' - TEXT_FIRST_CHAR;
+        const Rectangle &glyph = font.glyphs[index];
+
+        // Spaces advance without a quad
+        if (*c != ' ' && glyph.width > 0.0f) {
+            TextQuad &quad = layout.quads[layout.quadCount++];
+            quad.x0 = x;
+            quad.y0 = y;
+            quad.x1 = x + glyph.width * scale;
+            quad.y1 = y + glyph.height * scale;
+            quad.u0 = glyph.x / textureWidth;
+            quad.v0 = glyph.y / textureHeight;
+            quad.u1 = (glyph.x + glyph.width) / textureWidth;
+            quad.v1 = (glyph.y + glyph.height) / textureHeight;
+        }
+        x += (glyph.width + font.spacing) * scale;
+        if (x > layout.width) layout.width = x;
+    }
+    return true;
+}
+
+void DrawTextLayout(const TextLayout &layout, const TextFont &font, float x, float y, Color color) {
+    if (layout.quadCount == 0 || layout.textureId != font.texture.id) return;
+
+    rlCheckRenderBatchLimit(4 * layout.quadCount);
+    rlSetTexture(font.texture.id);
+    rlBegin(RL_QUADS);
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+        for (int i = 0; i < layout.quadCount; i++) {
+            const TextQuad &quad = layout.quads[i];
+            rlTexCoord2f(quad.u0, quad.v0);
+            rlVertex2f(x + quad.x0, y + quad.y0);
+            rlTexCoord2f(quad.u0, quad.v1);
+            rlVertex2f(x + quad.x0, y + quad.y1);
+            rlTexCoord2f(quad.u1, quad.v1);
+            rlVertex2f(x + quad.x1, y + quad.y1);
+            rlTexCoord2f(quad.u1, quad.v0);
+            rlVertex2f(x + quad.x1, y + quad.y0);
+        }
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void DrawTextQuick(const TextFont &font, const char *text, float x, float y, float fontSize, Color color) {
+    static TextLayout scratch;      // Main thread only
+    UpdateTextLayout(scratch, font, text, fontSize);
+    DrawTextLayout(scratch, font, x, y, color);
+}
+
+void ClearText(TextBuffer &buffer) {
+    buffer.text[0] = '\0';
+    buffer.length = 0;
+}
+
+void AppendText(TextBuffer &buffer, const char *text) {
+    while (*text != '\0' && buffer.length < TEXT_CHARS_MAX) buffer.text[buffer.length++] = *text++;
+    buffer.text[buffer.length] = '\0';
+}
+
+// Decimal digits of value, zero-padded to at least minDigits
+static void AppendDigits(TextBuffer &buffer, unsigned long long value, int minDigits) {
+    char digits[24];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0 || count < minDigits);
+    while (count > 0 && buffer.length < TEXT_CHARS_MAX) buffer.text[buffer.length++] = digits[--count];
+    buffer.text[buffer.length] = '\0';
+}
+
+void AppendInt(TextBuffer &buffer, int value) {
+    if (value < 0) AppendText(buffer, "-");
+    AppendDigits(buffer, (value < 0) ? 0ull - (unsigned long long)(long long)value : (unsigned long long)value, 1);
+}
+
+void AppendFloat(TextBuffer &buffer, float value, int decimals) {
+    if (decimals < 0) decimals = 0;
+    if (decimals > 6) decimals = 6;
+    if (!(value == value)) {            // NaN
+        AppendText(buffer, "nan");
+        return;
+    }
+    unsigned long long scale = 1;
+    for (int i = 0; i < decimals; i++) scale *= 10;
+    double magnitude = (value < 0.0f) ? -(double)value : (double)value;
+    if (magnitude * scale >= 1e18) {    // Past what the fixed point below holds
+        AppendText(buffer, (value < 0.0f) ? "-inf" : "inf");
+        return;
+    }
+    unsigned long long fixed = (unsigned long long)(magnitude * scale + 0.5);
+    if (value < 0.0f && fixed > 0) AppendText(buffer, "-");
+    AppendDigits(buffer, fixed / scale, 1);
+    if (decimals > 0) {
+        AppendText(buffer, ".");
+        AppendDigits(buffer, fixed % scale, decimals);
+    }
+}
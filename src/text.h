@@ -0,0 +1,73 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Bitmap font text
+//----------------------------------------------------------------------------------
+// A TextFont is one texture plus the source rectangle of every glyph. The UI font
+// (resources/font_arcadian.png) is a sprite font: glyph cells separated by a key
+// color, scanned on a loader thread by LoadTextFontImage() and uploaded once.
+//
+// A TextLayout holds a string already turned into textured quads relative to its
+// origin. UpdateTextLayout() only rebuilds them when the string, size or font
+// changed, so a HUD value that stays the same costs one string compare per frame.
+// DrawTextLayout() sends the quads to rlgl under a single texture bind, without
+// per-glyph lookups, measuring or allocation.
+//
+// TextBuffer and the Append*() helpers build strings in place of TextFormat(),
+// whose shared static buffers are overwritten every few calls.
+
+#define TEXT_FIRST_CHAR 32              // Glyphs cover ' ' .. '~' plus one
+#define TEXT_GLYPH_COUNT 96
+#define TEXT_CHARS_MAX 96               // Longest string a layout or buffer holds, excess is cut
+
+struct TextFont {
+    Texture2D texture;
+    float baseSize;                     // Glyph height in texels
+    float spacing;                      // Extra advance after each glyph, in texels
+    Rectangle glyphs[TEXT_GLYPH_COUNT];
+};
+
+struct TextQuad {
+    float x0, y0, x1, y1;               // Relative to the layout origin, in screen pixels
+    float u0, v0, u1, v1;
+};
+
+struct TextLayout {
+    char text[TEXT_CHARS_MAX + 1];      // What the quads were built from
+    unsigned int textureId;             // Font they were built for
+    float fontSize;
+    int quadCount;
+    float width;
+    float height;
+    TextQuad quads[TEXT_CHARS_MAX];
+};
+
+struct TextBuffer {
+    char text[TEXT_CHARS_MAX + 1];
+    int length;
+};
+
+// Scan a sprite font image (CPU only, safe on a loader thread), key color becomes transparent
+Image LoadTextFontImage(const char *fileName, Color key, TextFont &font);
+void UploadTextFont(Image &image, TextFont &font);     // Main thread, unloads image
+void UnloadTextFont(TextFont &font);
+
+// raylib's built-in font as a TextFont, drawn the way DrawText() would (needs the window)
+TextFont GetDefaultTextFont(void);
+
+// Rebuild the quads if text, fontSize or font differ from the last call, true if it did
+bool UpdateTextLayout(TextLayout &layout, const TextFont &font, const char *text, float fontSize);
+void DrawTextLayout(const TextLayout &layout, const TextFont &font, float x, float y, Color color);
+
+// Lay out and draw in one go through a scratch layout, for text drawn once into a UiCache
+void DrawTextQuick(const TextFont &font, const char *text, float x, float y, float fontSize, Color color);
+
+void ClearText(TextBuffer &buffer);
+void AppendText(TextBuffer &buffer, const char *text);
+void AppendInt(TextBuffer &buffer, int value);
+void AppendFloat(TextBuffer &buffer, float value, int decimals);   // Rounded, decimals 0..6
+
+#endif // TEXT_H
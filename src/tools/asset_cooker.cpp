@@ -0,0 +1,104 @@
+//----------------------------------------------------------------------------------
+// asset_cooker: pre-resize textures and pack the sprite atlas offline.
+//
+//   asset_cooker <resources base path> [--force]
+//
+// Writes <base>/resources/cooked/*.mgck. Outputs newer than their sources are
+// skipped unless --force is given. Uses raylib's image functions only, no window.
+//----------------------------------------------------------------------------------
+#include "raylib.h"
+#include "assets.h"
+#include "atlas.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+
+// Opaque images drop the alpha channel, a quarter less to read and upload
+static void ConvertToGpuFormat(Image *image) {
+    ImageFormat(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    const unsigned char *pixels = (const unsigned char *)image->data;
+    for (int i = 0; i < image->width * image->height; i++) {
+        if (pixels[i * 4 + 3] != 255) return;
+    }
+    ImageFormat(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+}
+
+static bool IsStale(const std::string &output, const std::string *sources, int count) {
+    if (!IsCookedImageCurrent(output.c_str())) return true;
+    long outputTime = GetFileModTime(output.c_str());
+    for (int i = 0; i < count; i++) {
+        if (GetFileModTime(sources[i].c_str()) > outputTime) return true;
+    }
+    return false;
+}
+
+static bool Write(const std::string &output, Image image) {
+    if (!SaveCookedImage(output.c_str(), image)) {
+        fprintf(stderr, "Can't write %s\n", output.c_str());
+        return false;
+    }
+    printf("cooked %s (%dx%d, %s)\n", output.c_str(), image.width, image.height,
+           (image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) ? "rgb8" : "rgba8");
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <resources base path> [--force]\n", argv[0]);
+        return 1;
+    }
+    std::string base = argv[1];
+    if (!base.empty() && base[base.size() - 1] != '/') base += '/';
+    bool force = (argc > 2) && (strcmp(argv[2], "--force") == 0);
+
+    SetTraceLogLevel(LOG_WARNING);
+    mkdir((base + COOKED_DIR).c_str(), 0755);
+    int failures = 0;
+
+    // Single textures, resized to their draw size if they have one
+    for (int i = 0; i < TEXTURE_ASSET_COUNT; i++) {
+        const TextureAsset &asset = TEXTURE_ASSETS[i];
+        std::string source = base + asset.sourcePath;
+        std::string output = base + COOKED_DIR + asset.cookedName + COOKED_EXT;
+        if (!force && !IsStale(output, &source, 1)) continue;
+
+        Image image = LoadImage(source.c_str());
+        if (image.data == nullptr) {
+            fprintf(stderr, "Can't load %s\n", source.c_str());
+            failures++;
+            continue;
+        }
+        if (asset.width > 0) ImageResize(&image, asset.width, asset.height);
+        ConvertToGpuFormat(&image);
+        if (!Write(output, image)) failures++;
+        UnloadImage(image);
+    }
+
+    // Sprite atlas page, with the same layout LoadTextureAtlas() computes at runtime
+    std::string sources[SPRITE_COUNT];
+    for (int i = 0; i < SPRITE_COUNT; i++) sources[i] = base + ATLAS_SPRITE_SOURCES[i].fileName;
+    std::string atlasOutput = base + COOKED_DIR COOKED_ATLAS_NAME COOKED_EXT;
+    if (force || IsStale(atlasOutput, sources, SPRITE_COUNT)) {
+        Rectangle sprites[SPRITE_COUNT];
+        int width = 0, height = 0;
+        if (!PackAtlasSprites(sprites, &width, &height)) {
+            fprintf(stderr, "Atlas sprites don't fit in %dx%d\n", width, height);
+            return 1;
+        }
+
+        Image images[SPRITE_COUNT];
+        for (int i = 0; i < SPRITE_COUNT; i++) {
+            images[i] = LoadImage(sources[i].c_str());
+            ImageResize(&images[i], ATLAS_SPRITE_SOURCES[i].width, ATLAS_SPRITE_SOURCES[i].height);
+        }
+        Image page = BuildAtlasImage(images, sprites, width, height);
+        ConvertToGpuFormat(&page);
+        if (!Write(atlasOutput, page)) failures++;
+        UnloadImage(page);
+        for (int i = 0; i < SPRITE_COUNT; i++) UnloadImage(images[i]);
+    }
+
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------------
+// bench: step the headless simulation with scripted clicks and report throughput.
+// Also prints per-mode game counts and score totals, which only change when the
+// simulation or its balance changes, so CI can diff them between builds.
+//
+// A second table times the marshmallow pool on its own: a batch roast update and
+// a burst of grid hit tests per step, over a SWARM layout of each size.
+//
+//   bench [frames per mode]
+//----------------------------------------------------------------------------------
+#include "game_state.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static const unsigned int MODE_KEYS[GAME_MODE_COUNT] = { GAME_KEY_ONE, GAME_KEY_TWO, GAME_KEY_THREE, GAME_KEY_FOUR, GAME_KEY_FIVE };
+
+static const float SCREEN_WIDTH = 800.0f;
+static const int POOL_SIZES[] = { 256, 1000, 10000 };
+static const int POOL_CLICKS_PER_STEP = 1000;
+
+// Scripted player: walks through the menus, then every few frames clicks the
+// on-screen marshmallow with the lowest index that has turned brown
+static GameInput ScriptInput(const GameState &state, GameMode mode, long frame) {
+    GameInput input = {};
+    switch (state.screen) {
+        case NAME_INPUT:
+            if (state.letterCount == 0) input.keyPressed = 'B';
+            else input.keys = GAME_KEY_ENTER;
+            break;
+        case MODE_SELECT:
+            input.keys = MODE_KEYS[mode];
+            break;
+        case GAMEPLAY: {
+            if (frame % 3 != 0) break;
+            const MarshmallowPool &pool = state.marshmallows;
+            static int visible[MARSHMALLOW_POOL_MAX];
+            int count = QueryMarshmallows(pool, state.platformScroll, state.platformScroll + SCREEN_WIDTH, visible, MARSHMALLOW_POOL_MAX);
+            int target = -1;
+            for (int k = 0; k < count; k++) {
+                if (pool.state[visible[k]] == 2 && (target < 0 || visible[k] < target)) target = visible[k];
+            }
+            if (target >= 0) {
+                input.mousePressed = true;
+                input.mouseX = GetMarshmallowViewX(pool, target, state.platformScroll) + MARSHMALLOW_SIZE / 2;
+                input.mouseY = pool.y[target] + MARSHMALLOW_SIZE / 2;
+            }
+            break;
+        }
+        default:
+            input.keys = GAME_KEY_ENTER;    // TITLE and ENDING advance on Enter
+            break;
+    }
+    input.keys |= GAME_SIGNAL_TITLE_READY | GAME_SIGNAL_GAMEPLAY_READY;    // Nothing to load headless
+    return input;
+}
+
+int main(int argc, char **argv)
+{
+    long frames = (argc > 1) ? atol(argv[1]) : 10000000;
+    const float dt = GAME_STEP_DT;     // One frame per simulation step
+
+    typedef std::chrono::steady_clock Clock;
+    double totalSeconds = 0.0;
+
+    printf("%-7s %12s %10s %12s %14s\n", "mode", "frames", "games", "score sum", "frames/s");
+    for (int m = 0; m < GAME_MODE_COUNT; m++) {
+        static GameState state;     // Too big for the stack
+        InitGameState(state, DEFAULT_GAME_RULES);
+        long games = 0, scoreSum = 0;
+
+        Clock::time_point start = Clock::now();
+        for (long frame = 0; frame < frames; frame++) {
+            GameStep(state, ScriptInput(state, (GameMode)m, frame), dt);
+            if (state.events & GAME_EVENT_GAME_OVER) {
+                games++;
+                scoreSum += state.score;
+            }
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        totalSeconds += seconds;
+
+        printf("%-7s %12ld %10ld %12ld %14.0f\n", GetGameModeString((GameMode)m), frames, games, scoreSum, frames / seconds);
+    }
+    printf("total   %12ld %38.0f\n", frames * GAME_MODE_COUNT, frames * GAME_MODE_COUNT / totalSeconds);
+
+    // Pool on its own: update every marshmallow, then hit-test a spread of points
+    printf("\n%-12s %8s %14s %14s %8s\n", "marshmallows", "steps", "update us", "clicks us", "hits");
+    static GameState swarm;
+    for (size_t s = 0; s < sizeof(POOL_SIZES) / sizeof(POOL_SIZES[0]); s++) {
+        GameRules rules = DEFAULT_GAME_RULES;
+        rules.swarmCount = POOL_SIZES[s];
+        InitGameState(swarm, rules);
+        GameInput pick = {};
+        pick.keys = GAME_SIGNAL_TITLE_READY | GAME_SIGNAL_GAMEPLAY_READY | GAME_KEY_FIVE;
+        swarm.screen = MODE_SELECT;
+        GameStep(swarm, pick, dt);
+        MarshmallowPool &pool = swarm.marshmallows;
+
+        std::vector<float> clickX(POOL_CLICKS_PER_STEP), clickY(POOL_CLICKS_PER_STEP);
+        srand(1);
+        for (int c = 0; c < POOL_CLICKS_PER_STEP; c++) {
+            clickX[c] = (float)rand() / RAND_MAX * pool.worldWidth;
+            clickY[c] = (float)rand() / RAND_MAX * (SWARM_TOP + DEFAULT_GAME_RULES.swarmRows * SWARM_ROW_HEIGHT);
+        }
+
+        const int steps = 1000;
+        double updateSeconds = 0.0, clickSeconds = 0.0;
+        long hits = 0;
+        for (int step = 0; step < steps; step++) {
+            Clock::time_point t0 = Clock::now();
+            UpdateMarshmallows(pool, dt, 1.0f, rules.roast);
+            Clock::time_point t1 = Clock::now();
+            for (int c = 0; c < POOL_CLICKS_PER_STEP; c++) hits += (FindMarshmallowAt(pool, clickX[c], clickY[c]) >= 0);
+            Clock::time_point t2 = Clock::now();
+            updateSeconds += std::chrono::duration<double>(t1 - t0).count();
+            clickSeconds += std::chrono::duration<double>(t2 - t1).count();
+        }
+        printf("%-12d %8d %14.2f %14.2f %8ld\n", pool.count, steps, updateSeconds * 1e6 / steps, clickSeconds * 1e6 / steps, hits / steps);
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+//----------------------------------------------------------------------------------
+// leaderboard_load: synthetic clients for tools/leaderboard_server. Each client
+// thread keeps up to WINDOW batches of random scores in flight (pipelined, like
+// a busy kiosk would), and one more connection subscribes and counts the top-N
+// pushes. Reports throughput and the time from sending a batch to its commit
+// being acknowledged.
+//
+//   leaderboard_load [port] [clients] [seconds] [batch]
+//----------------------------------------------------------------------------------
+#include "leaderboard_net.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+#define WINDOW 8                        // Batches in flight per client
+#define PLAYERS_PER_CLIENT 10000
+
+typedef std::chrono::steady_clock Clock;
+
+struct ClientResult {
+    long sent;
+    long acked;
+    bool failed;
+    std::vector<float> latencyMs;       // Per batch, send to acknowledgement
+};
+
+static std::atomic<bool> sending(true);
+
+static void RunClient(int port, int id, int batch, ClientResult &result) {
+    NetConnection connection;
+    if (!OpenNetConnection(connection, port)) {
+        result.failed = true;
+        return;
+    }
+
+    std::mt19937 rng(1234 + id);
+    std::uniform_int_distribution<int> playerDist(0, PLAYERS_PER_CLIENT - 1);
+    std::uniform_int_distribution<int> scoreDist(-20, 400);
+    std::uniform_real_distribution<float> timeDist(0.0f, 30.0f);
+    std::vector<NetScore> scores(batch);
+    std::deque<std::pair<Clock::time_point, int> > inFlight;    // Send time, scores not yet acknowledged
+    char name[32];
+
+    Clock::time_point drainDeadline;
+    for (;;) {
+        while (sending.load() && inFlight.size() < WINDOW) {
+            for (int i = 0; i < batch; i++) {
+                snprintf(name, sizeof(name), "load%02d_%05d", id, playerDist(rng));
+                scores[i] = MakeNetScore(name, scoreDist(rng), timeDist(rng), (GameMode)(rng() % GAME_MODE_COUNT));
+            }
+            if (!SendNetScores(connection, scores.data(), batch)) {
+                result.failed = true;
+                return;
+            }
+            inFlight.push_back(std::make_pair(Clock::now(), batch));
+            result.sent += batch;
+        }
+        if (inFlight.empty()) break;
+        if (!sending.load()) {
+            if (drainDeadline == Clock::time_point()) drainDeadline = Clock::now() + std::chrono::seconds(2);
+            if (Clock::now() >= drainDeadline) break;
+        }
+
+        NetMessage message;
+        int received = ReceiveNetMessage(connection, message, 100);
+        if (received < 0) {
+            result.failed = true;
+            return;
+        }
+        if (received == 0 || message.type != NET_MSG_ACK) continue;
+
+        // Acknowledgements count scores in send order, a batch is done once all of it is covered
+        int acked = message.count;
+        result.acked += acked;
+        while (acked > 0 && !inFlight.empty()) {
+            int taken = std::min(acked, inFlight.front().second);
+            inFlight.front().second -= taken;
+            acked -= taken;
+            if (inFlight.front().second == 0) {
+                result.latencyMs.push_back(std::chrono::duration<float, std::milli>(Clock::now() - inFlight.front().first).count());
+                inFlight.pop_front();
+            }
+        }
+    }
+    CloseNetConnection(connection);
+}
+
+static void RunSubscriber(int port, long &pushes) {
+    NetConnection connection;
+    if (!OpenNetConnection(connection, port) || !SendNetSubscribe(connection)) return;
+    NetMessage message;
+    while (sending.load()) {
+        int received = ReceiveNetMessage(connection, message, 100);
+        if (received < 0) break;
+        if (received > 0 && message.type == NET_MSG_TABLE) pushes++;
+    }
+    CloseNetConnection(connection);
+}
+
+int main(int argc, char **argv)
+{
+    int port = (argc > 1) ? atoi(argv[1]) : LEADERBOARD_PORT_DEFAULT;
+    int clientCount = (argc > 2) ? atoi(argv[2]) : 8;
+    double seconds = (argc > 3) ? atof(argv[3]) : 10.0;
+    int batch = (argc > 4) ? atoi(argv[4]) : 16;
+    if (clientCount < 1 || batch < 1 || batch > NET_SUBMIT_MAX) {
+        fprintf(stderr, "usage: %s [port] [clients] [seconds] [batch 1..%d]\n", argv[0], NET_SUBMIT_MAX);
+        return 1;
+    }
+
+    std::vector<ClientResult> results(clientCount);
+    std::vector<std::thread> threads;
+    long pushes = 0;
+    Clock::time_point start = Clock::now();
+    threads.push_back(std::thread(RunSubscriber, port, std::ref(pushes)));
+    for (int i = 0; i < clientCount; i++) {
+        results[i] = ClientResult();
+        threads.push_back(std::thread(RunClient, port, i, batch, std::ref(results[i])));
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    sending.store(false);
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    long sent = 0, acked = 0;
+    int failed = 0;
+    std::vector<float> latency;
+    for (int i = 0; i < clientCount; i++) {
+        sent += results[i].sent;
+        acked += results[i].acked;
+        failed += results[i].failed ? 1 : 0;
+        latency.insert(latency.end(), results[i].latencyMs.begin(), results[i].latencyMs.end());
+    }
+    if (failed == clientCount) {
+        fprintf(stderr, "No connection to 127.0.0.1:%d, is leaderboard_server running?\n", port);
+        return 1;
+    }
+
+    std::sort(latency.begin(), latency.end());
+    float p50 = latency.empty() ? 0.0f : latency[(latency.size() - 1) / 2];
+    float p99 = latency.empty() ? 0.0f : latency[(latency.size() - 1) * 99 / 100];
+    float worst = latency.empty() ? 0.0f : latency.back();
+    printf("%d clients (%d failed), batch %d, window %d, %.1f s\n", clientCount, failed, batch, WINDOW, elapsed);
+    printf("sent %ld, acknowledged %ld: %.0f scores/s committed\n", sent, acked, acked / elapsed);
+    printf("batch commit latency: p50 %.2f ms, p99 %.2f ms, max %.2f ms\n", p50, p99, worst);
+    printf("top-N pushes received by the subscriber: %ld\n", pushes);
+    return 0;
+}
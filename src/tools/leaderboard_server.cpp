@@ -0,0 +1,281 @@
+//----------------------------------------------------------------------------------
+// leaderboard_server: one leaderboard database shared by every game instance on
+// this machine. Games started with --leaderboard-port connect over TCP on
+// 127.0.0.1 (protocol in leaderboard_net.h).
+//
+//   leaderboard_server <database> [port]      (<name>.journal for the journal storage)
+//
+// Single-threaded poll() loop. Each pass reads everything every client has sent,
+// then commits all the scores that arrived in one transaction (group commit: the
+// longer a commit takes, the more the next one carries), acknowledges them, and
+// pushes the top N of each mode that changed to subscribers. Tables are kept
+// resident and updated with InsertLeaderboardEntry(), so a push needs no query.
+// If the commit fails it is rolled back and nothing is acknowledged; the clients
+// that sent scores are disconnected, and resend them when they reconnect.
+//----------------------------------------------------------------------------------
+#include "leaderboard.h"
+#include "leaderboard_net.h"
+#include <chrono>
+#include <csignal>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define CLIENTS_MAX 1024
+#define CLIENT_OUTBOX_MAX (1 << 20)     // A subscriber this far behind is dropped
+
+struct Client {
+    int socket;
+    bool subscribed;
+    int unacked;                        // Scores received from it since the last acknowledgement
+    std::vector<char> inbox;
+    std::vector<char> outbox;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+static LeaderboardTable tables[GAME_MODE_COUNT];
+
+static void OnStopSignal(int) { stopRequested = 1; }
+
+static void SetNonBlocking(int socket) {
+    fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void QueueMessage(Client &client, NetMessageType type, int count, const void *records, size_t size) {
+    NetHeader header = { (uint32_t)type, (uint32_t)count };
+    const char *bytes = (const char *)&header;
+    client.outbox.insert(client.outbox.end(), bytes, bytes + sizeof(header));
+    client.outbox.insert(client.outbox.end(), (const char *)records, (const char *)records + size);
+}
+
+static void QueueTable(Client &client, const LeaderboardTable &table) {
+    NetTable net = MakeNetTable(table);
+    QueueMessage(client, NET_MSG_TABLE, 1, &net, sizeof(net));
+}
+
+// Read what's available and take complete messages out, false if the client is gone or misbehaving
+static bool ReadClient(Client &client, std::vector<NetScore> &pending) {
+    char buffer[16384];
+    bool open = true;           // Still take what a client sent right before closing
+    for (;;) {
+        ssize_t received = recv(client.socket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            client.inbox.insert(client.inbox.end(), buffer, buffer + received);
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        open = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        break;
+    }
+
+    size_t offset = 0;
+    for (;;) {
+        int size = GetNetMessageSize(client.inbox.data() + offset, (int)(client.inbox.size() - offset));
+        if (size < 0) return false;
+        if (size == 0) break;
+
+        NetHeader header;
+        memcpy(&header, client.inbox.data() + offset, sizeof(header));
+        if (header.type == NET_MSG_SUBMIT) {
+            const NetScore *scores = (const NetScore *)(client.inbox.data() + offset + sizeof(header));
+            pending.insert(pending.end(), scores, scores + header.count);
+            client.unacked += header.count;
+        } else if (header.type == NET_MSG_SUBSCRIBE) {
+            client.subscribed = true;
+            for (int m = 0; m < GAME_MODE_COUNT; m++) QueueTable(client, tables[m]);
+        } else {
+            return false;       // Server-to-client message types
+        }
+        offset += size;
+    }
+    client.inbox.erase(client.inbox.begin(), client.inbox.begin() + offset);
+    return open;
+}
+
+// Send what the socket takes now, false if the client is gone or too far behind
+static bool FlushClient(Client &client) {
+    size_t sent = 0;
+    while (sent < client.outbox.size()) {
+        ssize_t n = send(client.socket, client.outbox.data() + sent, client.outbox.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) { sent += n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    client.outbox.erase(client.outbox.begin(), client.outbox.begin() + sent);
+    return client.outbox.size() <= CLIENT_OUTBOX_MAX;
+}
+
+// One transaction for everything received this pass, false if it didn't commit. Only
+// then are the resident tables updated, with a bit set in changed per mode whose top N moved.
+static bool CommitScores(std::vector<NetScore> &pending, unsigned &changed) {
+    changed = 0;
+    std::vector<size_t> newBests;
+    bool ok = BeginScoreBatch();
+    for (size_t i = 0; ok && i < pending.size(); i++) {
+        NetScore &score = pending[i];
+        if (score.mode < 0 || score.mode >= GAME_MODE_COUNT) continue;
+        score.name[sizeof(score.name) - 1] = '\0';
+        ScoreInsertResult result = InsertScore(score.name, score.score, score.time, (GameMode)score.mode);
+        if (result == SCORE_INSERT_FAILED) ok = false;
+        else if (result == SCORE_NEW_BEST) newBests.push_back(i);
+    }
+    ok = ok && CommitScoreBatch();
+    if (!ok) {
+        fprintf(stderr, "Commit of %d scores failed: %s\n", (int)pending.size(), GetDatabaseError());
+        RollbackScoreBatch();
+        for (int m = 0; m < GAME_MODE_COUNT; m++) LoadLeaderboard((GameMode)m, tables[m]);    // What did reach the disk
+        return false;
+    }
+
+    for (size_t i = 0; i < newBests.size(); i++) {
+        const NetScore &score = pending[newBests[i]];
+        if (InsertLeaderboardEntry(tables[score.mode], score.name, score.score, score.time)) changed |= 1u << score.mode;
+    }
+    return true;
+}
+
+static int OpenListener(int port) {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) return -1;
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);     // Never reachable from other machines
+    if (bind(listener, (const sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 128) != 0) {
+        close(listener);
+        return -1;
+    }
+    SetNonBlocking(listener);
+    return listener;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <database> [port]\n", argv[0]);
+        return 1;
+    }
+    int port = (argc > 2) ? atoi(argv[2]) : LEADERBOARD_PORT_DEFAULT;
+
+    SetLeaderboardStorage(GetLeaderboardStorageFor(argv[1]));
+    if (!InitDatabase(argv[1])) {
+        fprintf(stderr, "Can't open database: %s\n", GetDatabaseError());
+        return 1;
+    }
+    for (int m = 0; m < GAME_MODE_COUNT; m++) LoadLeaderboard((GameMode)m, tables[m]);
+
+    int listener = OpenListener(port);
+    if (listener < 0) {
+        fprintf(stderr, "Can't listen on 127.0.0.1:%d: %s\n", port, strerror(errno));
+        CloseDatabase();
+        return 1;
+    }
+    signal(SIGINT, OnStopSignal);
+    signal(SIGTERM, OnStopSignal);
+    printf("Listening on 127.0.0.1:%d\n", port);
+
+    typedef std::chrono::steady_clock Clock;
+    std::vector<Client> clients;
+    std::vector<pollfd> polled;
+    std::vector<NetScore> pending;
+    long intervalScores = 0, intervalCommits = 0;
+    Clock::time_point intervalStart = Clock::now();
+
+    while (!stopRequested) {
+        polled.clear();
+        pollfd listening = { listener, POLLIN, 0 };
+        polled.push_back(listening);
+        for (size_t i = 0; i < clients.size(); i++) {
+            pollfd client = { clients[i].socket, (short)(POLLIN | (clients[i].outbox.empty() ? 0 : POLLOUT)), 0 };
+            polled.push_back(client);
+        }
+        if (poll(polled.data(), polled.size(), 1000) < 0 && errno != EINTR) break;
+
+        // Read every client first, so one commit covers all of them
+        std::vector<bool> dropped(clients.size(), false);
+        for (size_t i = 0; i < clients.size(); i++) {
+            if ((polled[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) && !ReadClient(clients[i], pending)) dropped[i] = true;
+        }
+
+        if (!pending.empty()) {
+            unsigned changed = 0;
+            bool committed = CommitScores(pending, changed);
+            if (committed) {
+                intervalScores += pending.size();
+                intervalCommits++;
+            }
+            pending.clear();
+
+            for (size_t i = 0; i < clients.size(); i++) {
+                Client &client = clients[i];
+                if (client.unacked > 0 && !committed) {
+                    dropped[i] = true;      // Unacknowledged, they come back with the scores on reconnect
+                } else if (client.unacked > 0) {
+                    QueueMessage(client, NET_MSG_ACK, client.unacked, nullptr, 0);
+                    client.unacked = 0;
+                }
+                for (int m = 0; m < GAME_MODE_COUNT; m++) {
+                    if (client.subscribed && (changed & (1u << m))) QueueTable(client, tables[m]);
+                }
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < clients.size(); i++) {
+            if (dropped[i] || (!clients[i].outbox.empty() && !FlushClient(clients[i]))) {
+                close(clients[i].socket);
+                continue;
+            }
+            if (kept != i) clients[kept] = std::move(clients[i]);
+            kept++;
+        }
+        clients.resize(kept);
+
+        // Accepted after the pass, so their first poll() includes them
+        for (;;) {
+            int accepted = accept(listener, nullptr, nullptr);
+            if (accepted < 0) break;
+            if (clients.size() >= CLIENTS_MAX) {
+                close(accepted);
+                continue;
+            }
+            SetNonBlocking(accepted);
+            int noDelay = 1;
+            setsockopt(accepted, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            Client client;
+            client.socket = accepted;
+            client.subscribed = false;
+            client.unacked = 0;
+            clients.push_back(client);
+        }
+
+        double seconds = std::chrono::duration<double>(Clock::now() - intervalStart).count();
+        if (seconds >= 5.0) {
+            if (intervalCommits > 0) {
+                printf("%zu clients, %.0f scores/s, %.1f commits/s, %.1f scores per commit\n", clients.size(),
+                       intervalScores / seconds, intervalCommits / seconds, (double)intervalScores / intervalCommits);
+            }
+            intervalScores = intervalCommits = 0;
+            intervalStart = Clock::now();
+        }
+    }
+
+    for (size_t i = 0; i < clients.size(); i++) close(clients[i].socket);
+    close(listener);
+    CloseDatabase();
+    return 0;
+}
@@ -0,0 +1,477 @@
+//----------------------------------------------------------------------------------
+// tournament: play many headless games with simulated players, for difficulty
+// tuning. Every bot plays every mode under one set of GameRules (the defaults,
+// or overridden on the command line), and each (bot, mode) pair gets a CSV row
+// with its score and time-to-win distributions.
+//
+//   tournament [options]
+//     --games <n>               games per bot and mode (default 100000)
+//     --threads <n>             worker threads (default: all cores)
+//     --seed <n>                results depend only on this, not on thread timing
+//     --speed e,n,h,t,s         roastingSpeed per mode
+//     --win e,n,h,t,s           winScore per mode
+//     --roast yellow,brown,burnt    roast thresholds in seconds
+//     --time-limit <s>          TIMED game length
+//     --bot name,target,reaction,jitter,interval,miss   (repeat; replaces the default bots)
+//         target: yellow or brown, the state the bot waits for
+//         reaction/jitter: mean and standard deviation of the reaction time, seconds
+//         interval: least time between two clicks, seconds
+//         miss: chance a click lands on nothing
+//     --histograms <file>       also write every bin of both distributions
+//
+// Summary rows go to stdout, progress and throughput to stderr.
+//
+// Games are split into batches spread over per-thread deques. A thread takes from
+// the back of its own deque and steals from the front of the others' when it runs
+// dry, so threads that drew long games (slow bots, SWARM) don't hold up the rest.
+//----------------------------------------------------------------------------------
+#include "game_state.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BATCH_GAMES 256                 // Games per task
+#define GAME_SECONDS_MAX 600.0f         // A game not won by then counts as a timeout
+#define TIME_BINS_PER_SECOND 20
+#define SCORE_MIN -1000                 // Histogram range, scores outside are clamped into it
+#define SCORE_MAX 1000
+
+static const unsigned int MODE_KEYS[GAME_MODE_COUNT] = { GAME_KEY_ONE, GAME_KEY_TWO, GAME_KEY_THREE, GAME_KEY_FOUR, GAME_KEY_FIVE };
+static const float SCREEN_WIDTH = 800.0f;
+static const int TIME_BINS = (int)(GAME_SECONDS_MAX * TIME_BINS_PER_SECOND) + 1;
+static const int SCORE_BINS = SCORE_MAX - SCORE_MIN + 1;
+
+//----------------------------------------------------------------------------------
+// Bots
+//----------------------------------------------------------------------------------
+struct BotProfile {
+    std::string name;
+    int targetState;            // 1: click at yellow (safe), 2: wait for brown (greedy)
+    float reactionMean;         // Seconds from a marshmallow reaching targetState to the click
+    float reactionJitter;       // Standard deviation of that
+    float clickInterval;        // Least time between two clicks
+    float missChance;
+};
+
+static const float REACTION_MIN = 0.1f;
+
+static std::vector<BotProfile> GetDefaultBots(void) {
+    std::vector<BotProfile> bots;
+    BotProfile profiles[] = {
+        { "safe-fast",     1, 0.25f, 0.05f, 0.15f, 0.00f },
+        { "safe-slow",     1, 0.60f, 0.15f, 0.30f, 0.05f },
+        { "greedy-fast",   2, 0.25f, 0.05f, 0.15f, 0.00f },
+        { "greedy-slow",   2, 0.60f, 0.15f, 0.30f, 0.05f },
+        { "greedy-sloppy", 2, 0.40f, 0.25f, 0.20f, 0.15f },
+    };
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) bots.push_back(profiles[i]);
+    return bots;
+}
+
+// One bot playing one game: notices a marshmallow, reacts, clicks, waits out its interval
+struct BotPlayer {
+    const BotProfile *profile;
+    std::mt19937 *rng;
+    int target;                 // Marshmallow it is about to click, -1 if none
+    float clickAt;              // Game time of that click
+    float readyAt;              // Game time it can pick the next target
+};
+
+// Eligible marshmallow on screen that has roasted longest: at the bot's target
+// state or past it, burnt ones only if nothing else is (they never reset unclicked)
+static int PickTarget(const GameState &state, int targetState) {
+    static thread_local int visible[MARSHMALLOW_POOL_MAX];
+    const MarshmallowPool &pool = state.marshmallows;
+    int count = QueryMarshmallows(pool, state.platformScroll, state.platformScroll + SCREEN_WIDTH, visible, MARSHMALLOW_POOL_MAX);
+    int best = -1, burnt = -1;
+    for (int k = 0; k < count; k++) {
+        int i = visible[k];
+        float x = GetMarshmallowViewX(pool, i, state.platformScroll);
+        if (x < 0.0f || x + MARSHMALLOW_SIZE > SCREEN_WIDTH) continue;     // Only partly on screen
+        if (pool.state[i] == 3) {
+            if (burnt < 0 || pool.roastTimer[i] > pool.roastTimer[burnt]) burnt = i;
+        } else if (pool.state[i] >= targetState) {
+            if (best < 0 || pool.roastTimer[i] > pool.roastTimer[best]) best = i;
+        }
+    }
+    return (best >= 0) ? best : burnt;
+}
+
+static GameInput BotInput(BotPlayer &bot, const GameState &state, float now) {
+    GameInput input = {};
+    input.keys = GAME_SIGNAL_TITLE_READY | GAME_SIGNAL_GAMEPLAY_READY;
+    const BotProfile &profile = *bot.profile;
+
+    if (bot.target < 0 && now >= bot.readyAt) {
+        bot.target = PickTarget(state, profile.targetState);
+        if (bot.target >= 0) {
+            std::normal_distribution<float> reaction(profile.reactionMean, profile.reactionJitter);
+            bot.clickAt = now + std::max(REACTION_MIN, reaction(*bot.rng));
+        }
+    }
+
+    if (bot.target >= 0 && now >= bot.clickAt) {
+        // Clicks where the marshmallow is now, in whatever state it has reached meanwhile
+        const MarshmallowPool &pool = state.marshmallows;
+        float x = GetMarshmallowViewX(pool, bot.target, state.platformScroll) + MARSHMALLOW_SIZE / 2;
+        bool onScreen = x >= 0.0f && x < SCREEN_WIDTH;
+        std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+        if (onScreen && chance(*bot.rng) >= profile.missChance) {
+            input.mousePressed = true;
+            input.mouseX = x;
+            input.mouseY = pool.y[bot.target] + MARSHMALLOW_SIZE / 2;
+        }
+        bot.target = -1;
+        bot.readyAt = now + profile.clickInterval;
+    }
+    return input;
+}
+
+//----------------------------------------------------------------------------------
+// Results
+//----------------------------------------------------------------------------------
+// Distributions for one (bot, mode) pair, as histograms so any number of games fits
+struct CellStats {
+    long games;
+    long wins;
+    long timeouts;
+    long clicks;                    // On yellow or brown marshmallows
+    long burns;
+    double scoreSum;
+    double winTimeSum;
+    std::vector<long> scores;       // SCORE_BINS, from SCORE_MIN
+    std::vector<long> winTimes;     // TIME_BINS of 1/TIME_BINS_PER_SECOND seconds
+
+    CellStats() : games(0), wins(0), timeouts(0), clicks(0), burns(0), scoreSum(0.0), winTimeSum(0.0),
+                  scores(SCORE_BINS, 0), winTimes(TIME_BINS, 0) {}
+
+    void Merge(const CellStats &other) {
+        games += other.games;
+        wins += other.wins;
+        timeouts += other.timeouts;
+        clicks += other.clicks;
+        burns += other.burns;
+        scoreSum += other.scoreSum;
+        winTimeSum += other.winTimeSum;
+        for (int i = 0; i < SCORE_BINS; i++) scores[i] += other.scores[i];
+        for (int i = 0; i < TIME_BINS; i++) winTimes[i] += other.winTimes[i];
+    }
+};
+
+// Bin index holding the given fraction of a histogram's total (lowest bin at or past it)
+static int GetPercentileBin(const std::vector<long> &bins, long total, double fraction) {
+    if (total == 0) return -1;
+    long wanted = (long)ceil(fraction * total);
+    if (wanted < 1) wanted = 1;
+    long seen = 0;
+    for (size_t i = 0; i < bins.size(); i++) {
+        seen += bins[i];
+        if (seen >= wanted) return (int)i;
+    }
+    return (int)bins.size() - 1;
+}
+
+//----------------------------------------------------------------------------------
+// Work-stealing pool
+//----------------------------------------------------------------------------------
+struct Task {
+    int cell;                   // bot * GAME_MODE_COUNT + mode
+    long firstGame;             // Index of the batch's first game in its cell, seeds its RNG
+    int games;
+};
+
+// One deque per thread. Coarse tasks, so a mutex per deque is cheap next to the games
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int threads) : queues(threads), steals(0) {}
+
+    void Push(int thread, const Task &task) {
+        Queue &queue = queues[thread];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(task);
+    }
+
+    // Own work newest first, then the oldest task of the next non-empty deque; false once all are empty
+    bool Take(int thread, Task &task) {
+        {
+            Queue &own = queues[thread];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); k++) {
+            Queue &victim = queues[(thread + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;       // Nothing is pushed once the threads run, so this is final
+    }
+
+    long GetSteals(void) const { return steals.load(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<Queue> queues;
+    std::atomic<long> steals;
+};
+
+//----------------------------------------------------------------------------------
+// Tournament
+//----------------------------------------------------------------------------------
+struct Tournament {
+    GameRules rules;
+    std::vector<BotProfile> bots;
+    unsigned int seed;
+    long gamesPerCell;
+    std::atomic<long> gamesDone;
+};
+
+// Play one game from mode selection to the ending screen (or GAME_SECONDS_MAX)
+static void PlayGame(GameState &state, const BotProfile &profile, GameMode mode, std::mt19937 &rng, CellStats &stats) {
+    GameInput pick = {};
+    pick.keys = GAME_SIGNAL_TITLE_READY | GAME_SIGNAL_GAMEPLAY_READY | MODE_KEYS[mode];
+    state.screen = MODE_SELECT;
+    GameStep(state, pick, GAME_STEP_DT);
+
+    BotPlayer bot = { &profile, &rng, -1, 0.0f, 0.0f };
+    long steps = 0;
+    const long maxSteps = (long)(GAME_SECONDS_MAX * GAME_STEP_HZ);
+    while (state.screen == GAMEPLAY && steps < maxSteps) {
+        GameStep(state, BotInput(bot, state, steps * GAME_STEP_DT), GAME_STEP_DT);
+        steps++;
+        if (state.events & GAME_EVENT_CLICK) stats.clicks++;
+        if (state.events & GAME_EVENT_BURN) stats.burns++;
+    }
+
+    float seconds = steps * GAME_STEP_DT;
+    int score = std::min(SCORE_MAX, std::max(SCORE_MIN, state.score));
+    stats.games++;
+    stats.scoreSum += state.score;
+    stats.scores[score - SCORE_MIN]++;
+    if (state.screen == GAMEPLAY) {
+        stats.timeouts++;
+    } else if (state.score >= state.winScore) {
+        stats.wins++;
+        stats.winTimeSum += seconds;
+        stats.winTimes[std::min(TIME_BINS - 1, (int)(seconds * TIME_BINS_PER_SECOND))]++;
+    }
+}
+
+static void RunWorker(Tournament &tournament, WorkStealingPool &pool, int thread, std::vector<CellStats> &stats) {
+    std::unique_ptr<GameState> state(new GameState);    // Too big for the stack
+    InitGameState(*state, tournament.rules);
+    strcpy(state->playerName, "bot");
+    state->letterCount = 3;
+
+    Task task;
+    while (pool.Take(thread, task)) {
+        int bot = task.cell / GAME_MODE_COUNT;
+        GameMode mode = (GameMode)(task.cell % GAME_MODE_COUNT);
+        // Seeded by what the batch is, not by who runs it
+        std::seed_seq seeds = { tournament.seed, (unsigned int)task.cell, (unsigned int)task.firstGame };
+        std::mt19937 rng(seeds);
+        for (int g = 0; g < task.games; g++) PlayGame(*state, tournament.bots[bot], mode, rng, stats[task.cell]);
+        tournament.gamesDone.fetch_add(task.games, std::memory_order_relaxed);
+    }
+}
+
+static void WriteSummary(FILE *out, const Tournament &tournament, const std::vector<CellStats> &cells) {
+    static const double FRACTIONS[] = { 0.05, 0.25, 0.50, 0.75, 0.95 };
+    fprintf(out, "bot,mode,roasting_speed,win_score,games,wins,win_rate,timeouts,good_clicks_per_game,burns_per_game,"
+                 "score_mean,score_p05,score_p25,score_p50,score_p75,score_p95,"
+                 "win_time_mean,win_time_p05,win_time_p25,win_time_p50,win_time_p75,win_time_p95\n");
+    for (size_t c = 0; c < cells.size(); c++) {
+        const CellStats &cell = cells[c];
+        const BotProfile &bot = tournament.bots[c / GAME_MODE_COUNT];
+        GameMode mode = (GameMode)(c % GAME_MODE_COUNT);
+        double games = (cell.games > 0) ? (double)cell.games : 1.0;
+        fprintf(out, "%s,%s,%.3f,%d,%ld,%ld,%.4f,%ld,%.2f,%.2f,%.2f", bot.name.c_str(), GetGameModeString(mode),
+                tournament.rules.roastingSpeed[mode], tournament.rules.winScore[mode], cell.games, cell.wins,
+                cell.wins / games, cell.timeouts, cell.clicks / games, cell.burns / games, cell.scoreSum / games);
+        for (int f = 0; f < 5; f++) fprintf(out, ",%d", GetPercentileBin(cell.scores, cell.games, FRACTIONS[f]) + SCORE_MIN);
+        if (cell.wins > 0) {
+            fprintf(out, ",%.2f", cell.winTimeSum / cell.wins);
+            for (int f = 0; f < 5; f++) {
+                fprintf(out, ",%.2f", (double)GetPercentileBin(cell.winTimes, cell.wins, FRACTIONS[f]) / TIME_BINS_PER_SECOND);
+            }
+        } else {
+            fprintf(out, ",,,,,,");     // No wins, no times
+        }
+        fprintf(out, "\n");
+    }
+}
+
+static void WriteHistograms(FILE *out, const Tournament &tournament, const std::vector<CellStats> &cells) {
+    fprintf(out, "bot,mode,distribution,value,games\n");
+    for (size_t c = 0; c < cells.size(); c++) {
+        const char *bot = tournament.bots[c / GAME_MODE_COUNT].name.c_str();
+        const char *mode = GetGameModeString((GameMode)(c % GAME_MODE_COUNT));
+        for (int i = 0; i < SCORE_BINS; i++) {
+            if (cells[c].scores[i] > 0) fprintf(out, "%s,%s,score,%d,%ld\n", bot, mode, i + SCORE_MIN, cells[c].scores[i]);
+        }
+        for (int i = 0; i < TIME_BINS; i++) {
+            if (cells[c].winTimes[i] > 0) fprintf(out, "%s,%s,win_time,%.2f,%ld\n", bot, mode, (double)i / TIME_BINS_PER_SECOND, cells[c].winTimes[i]);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Command line
+//----------------------------------------------------------------------------------
+// Comma-separated numbers into values, true if exactly count were given
+static bool ParseFloats(const char *text, float *values, int count) {
+    char *end;
+    for (int i = 0; i < count; i++) {
+        values[i] = strtof(text, &end);
+        if (end == text) return false;
+        text = end;
+        if (i < count - 1) {
+            if (*text != ',') return false;
+            text++;
+        }
+    }
+    return *text == '\0';
+}
+
+static bool ParseBot(const char *text, BotProfile &bot) {
+    const char *comma = strchr(text, ',');
+    if (comma == nullptr) return false;
+    bot.name.assign(text, comma - text);
+    text = comma + 1;
+    if (strncmp(text, "yellow,", 7) == 0) bot.targetState = 1;
+    else if (strncmp(text, "brown,", 6) == 0) bot.targetState = 2;
+    else return false;
+    float values[4];
+    if (!ParseFloats(strchr(text, ',') + 1, values, 4)) return false;
+    bot.reactionMean = values[0];
+    bot.reactionJitter = values[1];
+    bot.clickInterval = values[2];
+    bot.missChance = values[3];
+    return !bot.name.empty() && bot.reactionJitter >= 0.0f;
+}
+
+int main(int argc, char **argv)
+{
+    Tournament tournament;
+    tournament.rules = DEFAULT_GAME_RULES;
+    tournament.seed = 1234;
+    tournament.gamesPerCell = 100000;
+    tournament.gamesDone.store(0);
+    int threadCount = (int)std::thread::hardware_concurrency();
+    const char *histogramPath = nullptr;
+
+    bool ok = true;
+    for (int i = 1; i < argc && ok; i++) {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        float values[GAME_MODE_COUNT];
+        if (value == nullptr) {
+            ok = false;
+        } else if (strcmp(argv[i], "--games") == 0) {
+            tournament.gamesPerCell = atol(value);
+            ok = tournament.gamesPerCell > 0;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threadCount = atoi(value);
+            ok = threadCount > 0;
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            tournament.seed = (unsigned int)strtoul(value, nullptr, 10);
+        } else if (strcmp(argv[i], "--speed") == 0) {
+            ok = ParseFloats(value, tournament.rules.roastingSpeed, GAME_MODE_COUNT);
+        } else if (strcmp(argv[i], "--win") == 0 && (ok = ParseFloats(value, values, GAME_MODE_COUNT))) {
+            for (int m = 0; m < GAME_MODE_COUNT; m++) tournament.rules.winScore[m] = (int)values[m];
+        } else if (strcmp(argv[i], "--roast") == 0 && (ok = ParseFloats(value, values, 3))) {
+            tournament.rules.roast.yellowTime = values[0];
+            tournament.rules.roast.brownTime = values[1];
+            tournament.rules.roast.burntTime = values[2];
+        } else if (strcmp(argv[i], "--time-limit") == 0) {
+            tournament.rules.timeLimit = (float)atof(value);
+        } else if (strcmp(argv[i], "--bot") == 0) {
+            BotProfile bot;
+            ok = ParseBot(value, bot);
+            if (ok) tournament.bots.push_back(bot);
+        } else if (strcmp(argv[i], "--histograms") == 0) {
+            histogramPath = value;
+        } else {
+            ok = false;
+        }
+        i++;
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: %s [--games n] [--threads n] [--seed n] [--speed e,n,h,t,s] [--win e,n,h,t,s]\n"
+                        "       [--roast yellow,brown,burnt] [--time-limit s] [--histograms file]\n"
+                        "       [--bot name,yellow|brown,reaction,jitter,interval,miss]...\n", argv[0]);
+        return 1;
+    }
+    if (tournament.bots.empty()) tournament.bots = GetDefaultBots();
+    if (threadCount < 1) threadCount = 1;
+
+    // Batches of every cell dealt round-robin, stealing evens out what each thread drew
+    int cellCount = (int)tournament.bots.size() * GAME_MODE_COUNT;
+    WorkStealingPool pool(threadCount);
+    int next = 0;
+    for (int c = 0; c < cellCount; c++) {
+        for (long first = 0; first < tournament.gamesPerCell; first += BATCH_GAMES) {
+            Task task = { c, first, (int)std::min<long>(BATCH_GAMES, tournament.gamesPerCell - first) };
+            pool.Push(next, task);
+            next = (next + 1) % threadCount;
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    std::vector<std::vector<CellStats> > threadStats(threadCount, std::vector<CellStats>(cellCount));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread(RunWorker, std::ref(tournament), std::ref(pool), t, std::ref(threadStats[t])));
+    }
+
+    long totalGames = tournament.gamesPerCell * cellCount;
+    for (;;) {
+        long done = tournament.gamesDone.load();
+        if (done >= totalGames) break;
+        fprintf(stderr, "\r%ld / %ld games", done, totalGames);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    for (int t = 0; t < threadCount; t++) threads[t].join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<CellStats> cells(cellCount);
+    for (int t = 0; t < threadCount; t++) {
+        for (int c = 0; c < cellCount; c++) cells[c].Merge(threadStats[t][c]);
+    }
+    fprintf(stderr, "\r%ld games on %d threads in %.1f s: %.0f games/s, %ld batches stolen\n", totalGames, threadCount,
+            seconds, totalGames / seconds, pool.GetSteals());
+
+    WriteSummary(stdout, tournament, cells);
+    if (histogramPath != nullptr) {
+        FILE *file = fopen(histogramPath, "w");
+        if (file == nullptr) {
+            fprintf(stderr, "Can't write %s\n", histogramPath);
+            return 1;
+        }
+        WriteHistograms(file, tournament, cells);
+        fclose(file);
+    }
+    return 0;
+}
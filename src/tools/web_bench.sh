@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+#----------------------------------------------------------------------------------
+# web_bench: build the web game twice, with the old ASYNCIFY + 64 MB initial heap settings
+# and with the current ones, then compare what the browser has to download and
+# compile: raw and gzip size of the .wasm/.js/.data, and how long the .wasm takes
+# to compile (median of several WebAssembly.compile() runs in node).
+#
+#   tools/web_bench.sh [output dir]       (run from src/, usually through make webbench)
+#
+# Time to the first frame needs a browser: serve each build, open it, and read
+# the "Startup: ..." line that shell.html logs to the console.
+#----------------------------------------------------------------------------------
+set -e
+
+OUT_DIR=${1:-build/tools/webbench}
+MAKE=${MAKE:-make}
+COMPILE_RUNS=${COMPILE_RUNS:-5}
+NAME=marshmallow_ghost_stack
+
+# variant name, then the make variables that select it
+build() {
+    local variant=$1; shift
+    echo "== building $variant"
+    "$MAKE" PLATFORM=PLATFORM_WEB COOK_ASSETS=FALSE WEB_BUILD_DIR="$OUT_DIR/$variant" "$@" >"$OUT_DIR/$variant.log" 2>&1 ||
+        { echo "build failed, see $OUT_DIR/$variant.log"; exit 1; }
+}
+
+size_of() {
+    [ -f "$1" ] || { echo "-"; return; }
+    echo "$(wc -c <"$1") / $(gzip -9 -c "$1" | wc -c)"
+}
+
+compile_ms() {
+    [ -f "$1" ] || { echo "-"; return; }
+    command -v node >/dev/null || { echo "- (no node)"; return; }
+    node -e '
+        const bytes = require("fs").readFileSync(process.argv[1]);
+        const runs = parseInt(process.argv[2]);
+        (async () => {
+            const times = [];
+            for (let i = 0; i < runs; i++) {
+                const start = process.hrtime.bigint();
+                await WebAssembly.compile(bytes);
+                times.push(Number(process.hrtime.bigint() - start) / 1e6);
+            }
+            times.sort((a, b) => a - b);
+            console.log(times[Math.floor(times.length / 2)].toFixed(1));
+        })();
+    ' "$1" "$COMPILE_RUNS"
+}
+
+mkdir -p "$OUT_DIR"
+build asyncify WEB_ASYNCIFY=TRUE WEB_INITIAL_MEMORY=67108864
+build plain WEB_ASYNCIFY=FALSE
+
+printf "\n%-10s %-22s %-22s %-22s %s\n" "variant" ".wasm bytes / gzip" ".js bytes / gzip" ".data bytes / gzip" "wasm compile ms (median)"
+for variant in asyncify plain; do
+    dir="$OUT_DIR/$variant"
+    printf "%-10s %-22s %-22s %-22s %s\n" "$variant" "$(size_of "$dir/$NAME.wasm")" "$(size_of "$dir/$NAME.js")" \
+        "$(size_of "$dir/$NAME.data")" "$(compile_ms "$dir/$NAME.wasm")"
+done
@@ -0,0 +1,45 @@
+#include "ui_cache.h"
+#include "rlgl.h"
+
+unsigned int HashUiKey(unsigned int hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void LoadUiCache(UiCache &cache, int width, int height) {
+    cache.target = LoadRenderTexture(width, height);
+    cache.key = 0;
+    cache.valid = false;
+}
+
+void UnloadUiCache(UiCache &cache) {
+    UnloadRenderTexture(cache.target);
+    cache = UiCache();
+}
+
+void DrawUiCache(UiCache &cache, unsigned int key, void (*drawContent)(void)) {
+    if (!cache.valid || cache.key != key) {
+        // Switching framebuffers mid-frame flushes the batch; only happens when the content changes
+        // Keep coverage in the alpha channel (plain alpha blending would square it at
+        // antialiased edges); the color ends up premultiplied, so blit it that way below
+        BeginTextureMode(cache.target);
+            ClearBackground(BLANK);
+            rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+            BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+                drawContent();
+            EndBlendMode();
+        EndTextureMode();
+        cache.key = key;
+        cache.valid = true;
+    }
+
+    // Render textures are stored bottom-up, flip with a negative source height
+    const Texture2D &texture = cache.target.texture;
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        DrawTextureRec(texture, (Rectangle){ 0, 0, (float)texture.width, (float)-texture.height }, (Vector2){ 0, 0 }, WHITE);
+    EndBlendMode();
+}
@@ -0,0 +1,33 @@
+#ifndef UI_CACHE_H
+#define UI_CACHE_H
+
+#include "raylib.h"
+#include <cstddef>
+
+//----------------------------------------------------------------------------------
+// Cached UI layer
+//----------------------------------------------------------------------------------
+// Screens whose content only changes with the data they show are drawn once into
+// a RenderTexture2D and then blitted as a single quad each frame. The caller
+// describes that data as a key (hash it with HashUiKey()); the content is redrawn
+// only when the key differs from the one it was drawn with.
+
+struct UiCache {
+    RenderTexture2D target;
+    unsigned int key;
+    bool valid;
+};
+
+#define UI_KEY_SEED 2166136261u         // FNV-1a offset basis
+
+// FNV-1a over size bytes of data, continuing from hash
+unsigned int HashUiKey(unsigned int hash, const void *data, size_t size);
+
+void LoadUiCache(UiCache &cache, int width, int height);
+void UnloadUiCache(UiCache &cache);
+
+// Redraw the content with drawContent if key changed, then draw the cached layer at (0, 0).
+// Call between BeginDrawing() and EndDrawing().
+void DrawUiCache(UiCache &cache, unsigned int key, void (*drawContent)(void));
+
+#endif // UI_CACHE_H